@@ -0,0 +1,58 @@
+/**
+ * Author: sascha_lammers@gmx.de
+ */
+
+#pragma once
+
+// configuration for the benchmarks. the ARDUINO_EEPROM_* settings can be changed with build flags
+
+#ifndef BENCHMARK_STATIC_DATA_SIZE
+#define BENCHMARK_STATIC_DATA_SIZE                          8
+#endif
+
+#ifndef BENCHMARK_WEAR_LEVEL_DATA_SIZE
+#define BENCHMARK_WEAR_LEVEL_DATA_SIZE                      11
+#endif
+
+typedef struct __attribute__((packed)) {
+    uint8_t data[BENCHMARK_STATIC_DATA_SIZE];
+} StaticData_t;
+
+typedef struct __attribute__((packed)) {
+    uint8_t data[BENCHMARK_WEAR_LEVEL_DATA_SIZE];
+} WearLevelData_t;
+
+#define ARDUINO_EEPROM_STATIC_DATA_SIZE                     sizeof(StaticData_t)
+#define ARDUINO_EEPROM_WEAR_LEVEL_DATA_SIZE                 sizeof(WearLevelData_t)
+
+#ifndef ARDUINO_EEPROM_STATIC_DATA_NUM_COPIES
+#define ARDUINO_EEPROM_STATIC_DATA_NUM_COPIES               3
+#endif
+
+// 768 byte for the wear leveling area
+#ifndef ARDUINO_EEPROM_LENGTH
+#define ARDUINO_EEPROM_LENGTH                               (768 + ARDUINO_EEPROM_STATIC_DATA_NUM_COPIES * (BENCHMARK_STATIC_DATA_SIZE + 6))
+#endif
+
+#if BENCHMARK_I2C
+// external I2C EEPROM, see benchmark/i2c.cpp
+#include <ArduinoEEPROMI2C.h>
+
+#ifndef BENCHMARK_I2C_SIZE
+#define BENCHMARK_I2C_SIZE                                  32768
+#endif
+
+#ifndef BENCHMARK_I2C_PAGE_SIZE
+#define BENCHMARK_I2C_PAGE_SIZE                             64
+#endif
+
+extern ArduinoEEPROMI2C I2CEEPROM;
+
+#define ARDUINO_EEPROM_CLASS                                ArduinoEEPROMI2C
+#define ARDUINO_EEPROM_OBJECT                               I2CEEPROM
+#define ARDUINO_EEPROM_MAX_LENGTH                           BENCHMARK_I2C_SIZE
+#endif
+
+template<class StaticDataType, class WearLevelDataType> class ArduinoEEPROMTpl;
+
+using ArduinoEEPROM = ArduinoEEPROMTpl<StaticData_t, WearLevelData_t>;
@@ -0,0 +1,188 @@
+/**
+ * Author: sascha_lammers@gmx.de
+ */
+
+// non-blocking write test with the EEPROM emulator and its write latency. writeStaticDataAsync() and
+// writeWearLevelDataAsync() are completed by calling poll() while the emulated clock advances. poll() must not
+// wait for the EEPROM and getAsyncResult() must report all copies. each write operation is interrupted by a power
+// cut at every write of a single byte, the new or the previous data must be readable after mounting the EEPROM
+// returns an error if poll() blocks, a copy is missing or the data cannot be recovered
+
+#include <Arduino.h>
+#include <EEPROM.h>
+#include "ArduinoEEPROM.h"
+
+// time between two calls of poll() in microseconds
+#ifndef BENCHMARK_POLL_INTERVAL
+#define BENCHMARK_POLL_INTERVAL                             500
+#endif
+
+struct PowerCut {
+};
+
+static uint8_t *_snapshot;
+static uint32_t _cuts;
+static uint32_t _errors;
+static uint32_t _polls;
+static uint32_t _busy;
+
+static void powerCut(EEPROMClass &)
+{
+    throw PowerCut();
+}
+
+static void error(const char *name, uint32_t round, const char *message)
+{
+    if (_errors++ < 10) {
+        printf("ERROR: %s round %u: %s\n", name, round, message);
+    }
+}
+
+// call poll() until the write operation has been completed. poll() must return immediately and must not write
+// while the EEPROM is busy
+static void pollUntilCompleted(const char *name, uint32_t round, ArduinoEEPROM &eeprom)
+{
+    for (;;) {
+        bool ready = EEPROM.isReady();
+        auto writes = EEPROM.getWrites();
+        auto start = micros();
+        bool completed = eeprom.poll();
+        _polls++;
+        if (micros() != start) {
+            error(name, round, "poll() waited for the EEPROM");
+        }
+        if (!ready) {
+            _busy++;
+            if (EEPROM.getWrites() != writes || completed) {
+                error(name, round, "poll() continued while the EEPROM was busy");
+            }
+        }
+        if (completed) {
+            break;
+        }
+        emulator_advance_micros(BENCHMARK_POLL_INTERVAL);
+    }
+}
+
+template<class DataType, class WriteCallback, class ReadCallback>
+static void run(const char *name, uint32_t round, const DataType &data, const DataType &previous, uint8_t expectedResult, WriteCallback write, ReadCallback read)
+{
+    DataType result;
+
+    // write without power cut and verify the result
+    memcpy(_snapshot, EEPROM.getData(), EEPROM.length());
+    {
+        ArduinoEEPROM eeprom;
+        eeprom.begin();
+        if (!write(eeprom, data)) {
+            error(name, round, "cannot start the write operation");
+        }
+        if (write(eeprom, data)) {
+            error(name, round, "second write operation started while pending");
+        }
+        pollUntilCompleted(name, round, eeprom);
+        if (eeprom.getAsyncResult() != expectedResult) {
+            error(name, round, "invalid result");
+        }
+        ArduinoEEPROM mounted;
+        mounted.begin();
+        if (!read(eeprom, result) || memcmp(&result, &data, sizeof(data)) != 0 || !read(mounted, result) || memcmp(&result, &data, sizeof(data)) != 0) {
+            error(name, round, "cannot read data");
+        }
+    }
+
+    // cut the power at each write operation of poll()
+    for (uint32_t cut = 0;; cut++) {
+        memcpy(EEPROM.getData(), _snapshot, EEPROM.length());
+        EEPROM.setPowerCut(cut, powerCut);
+        bool interrupted = false;
+        try {
+            ArduinoEEPROM eeprom;
+            eeprom.begin();
+            write(eeprom, data);
+            pollUntilCompleted(name, round, eeprom);
+        }
+        catch (PowerCut &) {
+            interrupted = true;
+            _cuts++;
+        }
+        EEPROM.powerOn();
+
+        ArduinoEEPROM eeprom;
+        eeprom.begin();
+        if (!read(eeprom, result)) {
+            if (!interrupted || round != 0) {
+                error(name, round, "cannot read data after power cut");
+            }
+        }
+        else if (memcmp(&result, &data, sizeof(data)) != 0 && (!interrupted || round == 0 || memcmp(&result, &previous, sizeof(previous)) != 0)) {
+            error(name, round, "invalid data after power cut");
+        }
+
+        // the next write operation must succeed
+        if (!write(eeprom, data)) {
+            error(name, round, "cannot start the write operation after power cut");
+        }
+        pollUntilCompleted(name, round, eeprom);
+        if (eeprom.getAsyncResult() != expectedResult || !read(eeprom, result) || memcmp(&result, &data, sizeof(data)) != 0) {
+            error(name, round, "cannot write data after power cut");
+        }
+        if (!interrupted) {
+            break;
+        }
+    }
+}
+
+int main()
+{
+    printf("data size %u/%u, block size %u, blocks %u, copies %u/%u, write latency %u us, poll interval %u us\n\n",
+        (unsigned)ArduinoEEPROM::staticDataTypeSize, (unsigned)ArduinoEEPROM::wearLevelDataTypeSize, (unsigned)ArduinoEEPROM::wearLevelBlockSize,
+        (unsigned)ArduinoEEPROM::wearLevelNumBlocks, (unsigned)ArduinoEEPROM::staticDataCopies, (unsigned)ArduinoEEPROM::wearLevelDataCopies,
+        EEPROM_EMULATOR_WRITE_LATENCY, BENCHMARK_POLL_INTERVAL
+    );
+
+    EEPROM.clear();
+    EEPROM.setWriteLatency(EEPROM_EMULATOR_WRITE_LATENCY);
+    {
+        ArduinoEEPROM eeprom;
+        eeprom.begin();
+        eeprom.eraseAndInitialize(ArduinoEEPROM::DataTypeEnum::ALL);
+    }
+
+    _snapshot = new uint8_t[EEPROM.length()];
+    StaticData_t staticData = {};
+    StaticData_t previousStaticData = {};
+    WearLevelData_t wearLevelData = {};
+    WearLevelData_t previousWearLevelData = {};
+
+    auto writeStaticData = [](ArduinoEEPROM &eeprom, const StaticData_t &data) {
+        return eeprom.writeStaticDataAsync(data);
+    };
+    auto readStaticData = [](ArduinoEEPROM &eeprom, StaticData_t &data) {
+        return eeprom.readStaticData(data) != 0;
+    };
+    auto writeWearLevelData = [](ArduinoEEPROM &eeprom, const WearLevelData_t &data) {
+        return eeprom.writeWearLevelDataAsync(data);
+    };
+    auto readWearLevelData = [](ArduinoEEPROM &eeprom, WearLevelData_t &data) {
+        return eeprom.readWearLevelData(data) != 0;
+    };
+
+    // the wear leveling area wraps around twice
+    uint32_t rounds = (ArduinoEEPROM::wearLevelNumBlocks / ArduinoEEPROM::wearLevelDataCopies) * 2 + 1;
+    auto start = micros();
+    for (uint32_t round = 0; round < rounds; round++) {
+        memset(staticData.data, round + 1, sizeof(staticData.data));
+        memset(wearLevelData.data, ~round, sizeof(wearLevelData.data));
+        if (round < 3) {
+            run("static data", round, staticData, previousStaticData, (1 << ArduinoEEPROM::staticDataCopies) - 1, writeStaticData, readStaticData);
+            previousStaticData = staticData;
+        }
+        run("wear leveling data", round, wearLevelData, previousWearLevelData, ArduinoEEPROM::wearLevelDataCopies, writeWearLevelData, readWearLevelData);
+        previousWearLevelData = wearLevelData;
+    }
+    delete[] _snapshot;
+
+    printf("rounds %u, polls %u, busy %u, emulated time %.1f s, power cuts %u, errors %u\n", rounds, _polls, _busy, (micros() - start) / 1000000.0, _cuts, _errors);
+    return _errors ? 1 : 0;
+}
@@ -0,0 +1,213 @@
+/**
+ * Author: sascha_lammers@gmx.de
+ */
+
+// CPU benchmark for the CRC, scan, read and write functions using the EEPROM emulator without write latency
+// reports the time and the number of EEPROM accesses per operation. the block size, number of copies
+// and page size are set with build flags (BENCHMARK_WEAR_LEVEL_DATA_SIZE, ARDUINO_EEPROM_WEAR_LEVEL_DATA_NUM_COPIES,
+// ARDUINO_EEPROM_PAGE_SIZE, ...). bus/op is the number of transactions, EEPROM_EMULATOR_BLOCK_ACCESS=1 emulates
+// an external EEPROM that transfers blocks
+
+#include <Arduino.h>
+#include <EEPROM.h>
+#include <time.h>
+#include "ArduinoEEPROM.h"
+
+#ifndef BENCHMARK_ITERATIONS
+#define BENCHMARK_ITERATIONS                                10000UL
+#endif
+
+volatile uint32_t benchmarkSink;
+
+class ArduinoEEPROMBenchmark {
+public:
+    using EEPROMSizeType = ArduinoEEPROM::EEPROMSizeType;
+    using DataBlockHeader_t = ArduinoEEPROM::DataBlockHeader_t;
+
+    typedef void (*Callback)(ArduinoEEPROMBenchmark &benchmark);
+
+    ArduinoEEPROMBenchmark() {
+        EEPROM.clear();
+        EEPROM.setWriteLatency(0);
+        _eeprom.begin();
+        _eeprom.eraseAndInitialize(ArduinoEEPROM::DataTypeEnum::ALL);
+        // fill the wear leveling area and wrap around once
+        for (uint32_t i = 0; i < ArduinoEEPROM::wearLevelNumBlocks * 3 / 2; i++) {
+            _data.data[0] = i;
+            _eeprom.writeWearLevelData(_data);
+        }
+        _eeprom.begin();
+        uint32_t cycleId;
+        _headOffset = _eeprom._getWearLevelHeadOffset(cycleId);
+    }
+
+    void run(const char *name, Callback callback, uint32_t iterations = BENCHMARK_ITERATIONS) {
+        EEPROM.resetCounters();
+        struct timespec start, end;
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        for (uint32_t i = 0; i < iterations; i++) {
+            callback(*this);
+        }
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        double ns = ((end.tv_sec - start.tv_sec) * 1e9 + (end.tv_nsec - start.tv_nsec)) / iterations;
+        printf("%-40s %12.1f %10.1f %10.1f %10.1f\n", name, ns, EEPROM.getReads() / (double)iterations, (EEPROM.getWrites() + EEPROM.getSkippedWrites()) / (double)iterations, EEPROM.getTransactions() / (double)iterations);
+    }
+
+    static void crc16Update(ArduinoEEPROMBenchmark &benchmark) {
+        benchmarkSink = ArduinoEEPROM::CRC::update((uint16_t)~0, &benchmark._data, sizeof(benchmark._data));
+    }
+
+    static void validateEepromDataBlockCrc(ArduinoEEPROMBenchmark &benchmark) {
+        DataBlockHeader_t header;
+        benchmarkSink = benchmark._eeprom._validateEepromDataBlockCrc(benchmark._headOffset, ArduinoEEPROM::wearLevelPayloadSize, header);
+    }
+
+    static void getWearLevelOffset(ArduinoEEPROMBenchmark &benchmark) {
+        uint32_t cycleId = 0;
+        benchmarkSink = benchmark._eeprom._getWearLevelOffset(cycleId);
+    }
+
+    static void findWearLevelHeadOffset(ArduinoEEPROMBenchmark &benchmark) {
+        uint32_t cycleId;
+        benchmarkSink = benchmark._eeprom._findWearLevelHeadOffset(cycleId);
+    }
+
+#if ARDUINO_EEPROM_HAVE_CHECKPOINT
+    static void findWearLevelHeadOffsetFromCheckpoint(ArduinoEEPROMBenchmark &benchmark) {
+        uint32_t cycleId;
+        benchmarkSink = benchmark._eeprom._findWearLevelHeadOffsetFromCheckpoint(cycleId);
+    }
+#endif
+
+    static void compareDataBlock(ArduinoEEPROMBenchmark &benchmark) {
+        benchmarkSink = benchmark._eeprom._compareDataBlock(benchmark._headOffset, ConstByteAccessArray(&benchmark._data), ArduinoEEPROM::wearLevelDataTypeSize);
+    }
+
+    static void readWearLevelData(ArduinoEEPROMBenchmark &benchmark) {
+        WearLevelData_t data;
+        benchmarkSink = benchmark._eeprom.readWearLevelData(data);
+    }
+
+    static void writeWearLevelData(ArduinoEEPROMBenchmark &benchmark) {
+        benchmark._data.data[0]++;
+        benchmarkSink = benchmark._eeprom.writeWearLevelData(benchmark._data);
+    }
+
+    static void writeWearLevelDataIfModified(ArduinoEEPROMBenchmark &benchmark) {
+        benchmarkSink = benchmark._eeprom.writeWearLevelDataIfModified(benchmark._data);
+    }
+
+#if ARDUINO_EEPROM_HAVE_COUNTER
+    static void incrementCounter(ArduinoEEPROMBenchmark &benchmark) {
+        benchmarkSink = benchmark._eeprom.incrementCounter();
+    }
+#endif
+
+#if ARDUINO_EEPROM_HAVE_TIME_SERIES
+    struct Sample_t {
+        uint8_t data[ArduinoEEPROM::timeSeriesSampleSize];
+    };
+
+    static void appendSample(ArduinoEEPROMBenchmark &benchmark) {
+        Sample_t sample = {};
+        sample.data[0] = ++benchmark._data.data[0];
+        benchmarkSink = benchmark._eeprom.appendSample(sample);
+    }
+
+    static void readSample(ArduinoEEPROMBenchmark &benchmark) {
+        // read all samples and start over with the oldest one
+        Sample_t sample;
+        if (!benchmark._eeprom.readSample(benchmark._samples, sample)) {
+            benchmark._eeprom.beginSamples(benchmark._samples);
+            benchmark._eeprom.readSample(benchmark._samples, sample);
+        }
+        benchmarkSink = sample.data[0];
+    }
+#endif
+
+#if ARDUINO_EEPROM_HAVE_HISTORY
+    static void readHistory(ArduinoEEPROMBenchmark &benchmark) {
+        // walk all records and start over with the latest one
+        WearLevelData_t data;
+        if (!benchmark._eeprom.readHistory(benchmark._history, data)) {
+            benchmark._eeprom.beginHistory(benchmark._history);
+            benchmark._eeprom.readHistory(benchmark._history, data);
+        }
+        benchmarkSink = benchmark._history.cycleId;
+    }
+
+    static void readHistoryByCycleId(ArduinoEEPROMBenchmark &benchmark) {
+        WearLevelData_t data;
+        benchmarkSink = benchmark._eeprom.readHistory(benchmark._history.cycleId, data);
+    }
+#endif
+
+#if ARDUINO_EEPROM_HAVE_RECORD_STORE
+    static void writeRecord(ArduinoEEPROMBenchmark &benchmark) {
+        // 4 byte records with the keys used in turn
+        uint32_t value = ++benchmark._data.data[0];
+        benchmarkSink = benchmark._eeprom.writeRecord(value % ArduinoEEPROM::recordMaxKeys, value);
+    }
+
+    static void readRecord(ArduinoEEPROMBenchmark &benchmark) {
+        uint32_t value;
+        benchmarkSink = benchmark._eeprom.readRecord(0, value);
+    }
+
+    static void readRecords(ArduinoEEPROMBenchmark &benchmark) {
+        benchmark._eeprom._readRecords();
+        benchmarkSink = benchmark._eeprom._recordHeadOffset;
+    }
+#endif
+
+private:
+    ArduinoEEPROM _eeprom;
+    WearLevelData_t _data = {};
+    EEPROMSizeType _headOffset;
+#if ARDUINO_EEPROM_HAVE_HISTORY
+    ArduinoEEPROM::HistoryIterator_t _history = {};
+#endif
+#if ARDUINO_EEPROM_HAVE_TIME_SERIES
+    ArduinoEEPROM::TimeSeriesIterator_t _samples = {};
+#endif
+};
+
+int main()
+{
+    printf("data size %u, block size %u, blocks %u, copies %u, page size %u, crc engine %u, block access %u/%u, %lu iterations\n\n",
+        (unsigned)ArduinoEEPROM::wearLevelDataTypeSize, (unsigned)ArduinoEEPROM::wearLevelBlockSize, (unsigned)ArduinoEEPROM::wearLevelNumBlocks,
+        (unsigned)ArduinoEEPROM::wearLevelDataCopies, (unsigned)ArduinoEEPROM::pageSize, ARDUINO_EEPROM_CRC_ENGINE,
+        ArduinoEEPROM::BlockAccess::hasBlockRead, ArduinoEEPROM::BlockAccess::hasBlockWrite, (unsigned long)BENCHMARK_ITERATIONS
+    );
+    printf("%-40s %12s %10s %10s %10s\n", "function", "ns/op", "reads/op", "writes/op", "bus/op");
+
+    ArduinoEEPROMBenchmark benchmark;
+    benchmark.run("CRC::update", ArduinoEEPROMBenchmark::crc16Update);
+    benchmark.run("_validateEepromDataBlockCrc", ArduinoEEPROMBenchmark::validateEepromDataBlockCrc);
+    benchmark.run("_getWearLevelOffset", ArduinoEEPROMBenchmark::getWearLevelOffset);
+    benchmark.run("_findWearLevelHeadOffset", ArduinoEEPROMBenchmark::findWearLevelHeadOffset);
+#if ARDUINO_EEPROM_HAVE_CHECKPOINT
+    benchmark.run("_findWearLevelHeadOffsetFromCheckpoint", ArduinoEEPROMBenchmark::findWearLevelHeadOffsetFromCheckpoint);
+#endif
+    benchmark.run("_compareDataBlock", ArduinoEEPROMBenchmark::compareDataBlock);
+    benchmark.run("readWearLevelData", ArduinoEEPROMBenchmark::readWearLevelData);
+    benchmark.run("writeWearLevelData", ArduinoEEPROMBenchmark::writeWearLevelData);
+    benchmark.run("writeWearLevelDataIfModified", ArduinoEEPROMBenchmark::writeWearLevelDataIfModified);
+#if ARDUINO_EEPROM_HAVE_COUNTER
+    benchmark.run("incrementCounter", ArduinoEEPROMBenchmark::incrementCounter);
+#endif
+#if ARDUINO_EEPROM_HAVE_TIME_SERIES
+    benchmark.run("appendSample", ArduinoEEPROMBenchmark::appendSample);
+    benchmark.run("readSample", ArduinoEEPROMBenchmark::readSample);
+#endif
+#if ARDUINO_EEPROM_HAVE_HISTORY
+    benchmark.run("readHistory", ArduinoEEPROMBenchmark::readHistory);
+    benchmark.run("readHistory(cycleId)", ArduinoEEPROMBenchmark::readHistoryByCycleId);
+#endif
+#if ARDUINO_EEPROM_HAVE_RECORD_STORE
+    benchmark.run("writeRecord", ArduinoEEPROMBenchmark::writeRecord);
+    benchmark.run("readRecord", ArduinoEEPROMBenchmark::readRecord);
+    benchmark.run("_readRecords", ArduinoEEPROMBenchmark::readRecords, BENCHMARK_ITERATIONS / 10);
+#endif
+    return 0;
+}
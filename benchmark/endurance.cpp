@@ -0,0 +1,155 @@
+/**
+ * Author: sascha_lammers@gmx.de
+ */
+
+// endurance benchmark. writes wear leveling data with different workloads to the EEPROM emulator and
+// reports the physical bytes written per write, the writes per cell and the projected lifetime
+// returns an error if the wear leveling does not distribute the writes evenly or a limit is exceeded
+
+#include <Arduino.h>
+#include <EEPROM.h>
+#include "ArduinoEEPROM.h"
+
+// number of writes per workload
+#ifndef BENCHMARK_WRITES
+#define BENCHMARK_WRITES                                    100000UL
+#endif
+
+// write cycles of a single cell
+#ifndef BENCHMARK_CELL_ENDURANCE
+#define BENCHMARK_CELL_ENDURANCE                            100000UL
+#endif
+
+// max. physical bytes written per write, 0 = no limit
+#ifndef BENCHMARK_MAX_BYTES_PER_WRITE
+#define BENCHMARK_MAX_BYTES_PER_WRITE                       0
+#endif
+
+// max. physical bytes written per write of each workload. the envs in platformio.ini set the baselines of their
+// configuration
+#ifndef BENCHMARK_MAX_BYTES_PER_WRITE_COUNTER
+#define BENCHMARK_MAX_BYTES_PER_WRITE_COUNTER               BENCHMARK_MAX_BYTES_PER_WRITE
+#endif
+#ifndef BENCHMARK_MAX_BYTES_PER_WRITE_RANDOM
+#define BENCHMARK_MAX_BYTES_PER_WRITE_RANDOM                BENCHMARK_MAX_BYTES_PER_WRITE
+#endif
+#ifndef BENCHMARK_MAX_BYTES_PER_WRITE_SLOW
+#define BENCHMARK_MAX_BYTES_PER_WRITE_SLOW                  BENCHMARK_MAX_BYTES_PER_WRITE
+#endif
+#ifndef BENCHMARK_MAX_BYTES_PER_WRITE_SPARSE
+#define BENCHMARK_MAX_BYTES_PER_WRITE_SPARSE                BENCHMARK_MAX_BYTES_PER_WRITE
+#endif
+
+typedef void (*WorkloadCallback)(WearLevelData_t &data, uint32_t n);
+
+static uint32_t _random = 1;
+
+static uint8_t _rand()
+{
+    _random = _random * 1103515245UL + 12345;
+    return _random >> 16;
+}
+
+// 32 bit counter incremented with each write
+static void workloadCounter(WearLevelData_t &data, uint32_t n)
+{
+    uint32_t counter = n;
+    memcpy(data.data, &counter, min(sizeof(counter), sizeof(data.data)));
+}
+
+// all bytes are random
+static void workloadRandom(WearLevelData_t &data, uint32_t)
+{
+    for (auto &byte : data.data) {
+        byte = _rand();
+    }
+}
+
+// a single byte changes with each write, the other bytes every 100th write
+static void workloadSlow(WearLevelData_t &data, uint32_t n)
+{
+    data.data[0] = n;
+    if (n % 100 == 0) {
+        for (uint8_t i = 1; i < sizeof(data.data); i++) {
+            data.data[i] = _rand();
+        }
+    }
+}
+
+// 2-4 random bytes change with each write
+static void workloadSparse(WearLevelData_t &data, uint32_t)
+{
+    for (uint8_t i = 2 + _rand() % 3; i; i--) {
+        data.data[_rand() % sizeof(data.data)] = _rand();
+    }
+}
+
+static bool runWorkload(const char *name, WorkloadCallback callback, double maxBytesPerWrite)
+{
+    ArduinoEEPROM eeprom;
+    EEPROM.clear();
+    EEPROM.setWriteLatency(0);
+    eeprom.begin();
+    eeprom.eraseAndInitialize(ArduinoEEPROM::DataTypeEnum::ALL);
+    EEPROM.resetCounters();
+
+    WearLevelData_t data;
+    memset(&data, 0, sizeof(data));
+    uint32_t failed = 0;
+    for (uint32_t n = 1; n <= BENCHMARK_WRITES; n++) {
+        callback(data, n);
+        if (eeprom.writeWearLevelData(data) != ArduinoEEPROM::wearLevelDataCopies) {
+            failed++;
+        }
+    }
+
+    uint32_t maxWrites = 0;
+    uint64_t totalWrites = 0;
+    for (uint32_t i = ArduinoEEPROM::wearLevelDataOffset; i < ArduinoEEPROM::wearLevelDataOffset + ArduinoEEPROM::wearLevelDataLength; i++) {
+        auto count = EEPROM.getWriteCount(i);
+        maxWrites = max(maxWrites, count);
+        totalWrites += count;
+    }
+    double bytesPerWrite = EEPROM.getWrites() / (double)BENCHMARK_WRITES;
+    double meanWrites = totalWrites / (double)ArduinoEEPROM::wearLevelDataLength;
+    double lifetime = BENCHMARK_CELL_ENDURANCE * (BENCHMARK_WRITES / (double)max(maxWrites, 1U));
+
+    printf("%-10s %10.2f %10u %10.1f %14.0f %8.1fx\n", name, bytesPerWrite, maxWrites, meanWrites, lifetime, lifetime / BENCHMARK_CELL_ENDURANCE);
+
+    bool result = true;
+    if (failed) {
+        printf("ERROR: %u writes failed\n", failed);
+        result = false;
+    }
+    // each write uses wearLevelDataCopies blocks and every block is written once per cycle
+    uint32_t expectedMaxWrites = (BENCHMARK_WRITES * ArduinoEEPROM::wearLevelDataCopies + ArduinoEEPROM::wearLevelNumBlocks - 1) / ArduinoEEPROM::wearLevelNumBlocks;
+    if (maxWrites > expectedMaxWrites) {
+        printf("ERROR: max. writes per cell %u exceeds %u\n", maxWrites, expectedMaxWrites);
+        result = false;
+    }
+    if (bytesPerWrite > ArduinoEEPROM::wearLevelDataCopies * ArduinoEEPROM::wearLevelBlockSize) {
+        printf("ERROR: %.2f bytes per write exceeds the block size\n", bytesPerWrite);
+        result = false;
+    }
+    if (maxBytesPerWrite && bytesPerWrite > maxBytesPerWrite) {
+        printf("ERROR: %.2f bytes per write exceeds %.2f\n", bytesPerWrite, maxBytesPerWrite);
+        result = false;
+    }
+    return result;
+}
+
+int main()
+{
+    printf("data size %u, block size %u, blocks %u, copies %u, wear leveling area %u byte, %lu writes\n\n",
+        (unsigned)ArduinoEEPROM::wearLevelDataTypeSize, (unsigned)ArduinoEEPROM::wearLevelBlockSize, (unsigned)ArduinoEEPROM::wearLevelNumBlocks,
+        (unsigned)ArduinoEEPROM::wearLevelDataCopies, (unsigned)ArduinoEEPROM::wearLevelDataLength, (unsigned long)BENCHMARK_WRITES
+    );
+    printf("%-10s %10s %10s %10s %14s %9s\n", "workload", "byte/write", "max/cell", "mean/cell", "lifetime", "factor");
+
+    bool result = true;
+    result &= runWorkload("counter", workloadCounter, BENCHMARK_MAX_BYTES_PER_WRITE_COUNTER);
+    result &= runWorkload("random", workloadRandom, BENCHMARK_MAX_BYTES_PER_WRITE_RANDOM);
+    result &= runWorkload("slow", workloadSlow, BENCHMARK_MAX_BYTES_PER_WRITE_SLOW);
+    result &= runWorkload("sparse", workloadSparse, BENCHMARK_MAX_BYTES_PER_WRITE_SPARSE);
+    return result ? 0 : 1;
+}
@@ -0,0 +1,248 @@
+/**
+ * Author: sascha_lammers@gmx.de
+ */
+
+// fault injection test with the EEPROM emulator. the wear leveling data is written to cells that wear out or
+// have stuck bits. a write operation that reports a written copy must be readable, by the same object and after
+// mounting the EEPROM again, the data must never roll back to an older write operation. with
+// ARDUINO_EEPROM_HAVE_SCRUB=1, corrupted copies of the static data must be repaired by scrub() and invalid blocks
+// must be reported
+// returns an error if the data cannot be read, is older than the last successful write operation or scrub() does
+// not repair or report the corrupted data
+
+#include <Arduino.h>
+#include <EEPROM.h>
+#include "ArduinoEEPROM.h"
+
+// write cycles of a single cell
+#ifndef BENCHMARK_FAULTS_ENDURANCE
+#define BENCHMARK_FAULTS_ENDURANCE                          300
+#endif
+
+// number of writes after the cells have been worn out
+#ifndef BENCHMARK_FAULTS_WRITES
+#define BENCHMARK_FAULTS_WRITES                             (BENCHMARK_FAULTS_ENDURANCE * ArduinoEEPROM::wearLevelNumBlocks)
+#endif
+
+static uint32_t _errors;
+
+static void error(const char *name, uint32_t round, const char *message)
+{
+    if (_errors++ < 10) {
+        printf("ERROR: %s write %u: %s\n", name, round, message);
+    }
+}
+
+static void format()
+{
+    EEPROM.clear();
+    EEPROM.setWriteLatency(0);
+    ArduinoEEPROM eeprom;
+    eeprom.begin();
+    eeprom.eraseAndInitialize(ArduinoEEPROM::DataTypeEnum::ALL);
+}
+
+// all bytes contain the number of the write operation
+static void setData(WearLevelData_t &data, uint32_t n)
+{
+    memset(data.data, n, sizeof(data.data));
+    memcpy(data.data, &n, min(sizeof(n), sizeof(data.data)));
+}
+
+// returns true if result is the last successful write operation. after a failed write operation, the blocks of the
+// previous data might have been overwritten and the data of an older write operation is accepted
+static bool verifyData(const WearLevelData_t &result, uint32_t successful, bool failed)
+{
+    uint32_t n = 0;
+    memcpy(&n, result.data, min(sizeof(n), sizeof(result.data)));
+    if (n != successful && (!failed || n == 0 || n > successful)) {
+        return false;
+    }
+    WearLevelData_t data;
+    setData(data, n);
+    return memcmp(&result, &data, sizeof(data)) == 0;
+}
+
+static bool writeSync(ArduinoEEPROM &eeprom, const WearLevelData_t &data)
+{
+    return eeprom.writeWearLevelData(data) != 0;
+}
+
+#if ARDUINO_EEPROM_HAVE_ASYNC_WRITE
+static bool writeAsync(ArduinoEEPROM &eeprom, const WearLevelData_t &data)
+{
+    if (!eeprom.writeWearLevelDataAsync(data)) {
+        return false;
+    }
+    eeprom.flushAsync();
+    return eeprom.getAsyncResult() != 0;
+}
+#endif
+
+// write the wear leveling data BENCHMARK_FAULTS_WRITES times. the last successful write operation must be
+// readable after each write
+static void writeAndVerify(const char *name, bool (*write)(ArduinoEEPROM &eeprom, const WearLevelData_t &data))
+{
+    ArduinoEEPROM eeprom;
+    eeprom.begin();
+    WearLevelData_t data;
+    WearLevelData_t result;
+    uint32_t successful = 0;
+    uint32_t failed = 0;
+    for (uint32_t n = 1; n <= BENCHMARK_FAULTS_WRITES; n++) {
+        setData(data, n);
+        bool written = write(eeprom, data);
+        if (written) {
+            successful = n;
+        }
+        else {
+            failed++;
+        }
+        if (!successful) {
+            continue;
+        }
+        // the data might not be readable after a failed write operation
+        if (eeprom.readWearLevelData(result) ? !verifyData(result, successful, !written) : written) {
+            error(name, n, "cannot read the data");
+        }
+        ArduinoEEPROM mounted;
+        mounted.begin();
+        if (mounted.readWearLevelData(result) ? !verifyData(result, successful, !written) : written) {
+            error(name, n, "cannot read the data after mounting the EEPROM");
+        }
+    }
+#if ARDUINO_EEPROM_HAVE_BAD_BLOCKS
+    printf("%-12s writes %u, failed %u, bad blocks %u, errors %u\n", name, (unsigned)BENCHMARK_FAULTS_WRITES, failed, (unsigned)eeprom.getNumBadBlocks(), _errors);
+#else
+    printf("%-12s writes %u, failed %u, errors %u\n", name, (unsigned)BENCHMARK_FAULTS_WRITES, failed, _errors);
+#endif
+}
+
+// all cells wear out after BENCHMARK_FAULTS_ENDURANCE write cycles
+static void testWornOut(const char *name, bool (*write)(ArduinoEEPROM &eeprom, const WearLevelData_t &data))
+{
+    format();
+    EEPROM.setEndurance(BENCHMARK_FAULTS_ENDURANCE);
+    writeAndVerify(name, write);
+    EEPROM.setEndurance(0);
+}
+
+// a bit of the payload and the CRC of the first block is stuck
+static void testStuckBits()
+{
+    format();
+    EEPROM.setStuckBits(ArduinoEEPROM::wearLevelDataOffset + ArduinoEEPROM::dataBlockHeaderSize, 0x01, 0x01);
+    EEPROM.setStuckBits(ArduinoEEPROM::wearLevelDataOffset, 0x80, 0x00);
+    writeAndVerify("stuck bits", writeSync);
+}
+
+#if ARDUINO_EEPROM_HAVE_SCRUB
+
+// number of blocks checked by each call of scrub()
+#ifndef BENCHMARK_SCRUB_BUDGET
+#define BENCHMARK_SCRUB_BUDGET                              4
+#endif
+
+// call scrub() until the pass has been completed
+static const ArduinoEEPROM::ScrubState_t &scrubPass(ArduinoEEPROM &eeprom)
+{
+    while (!eeprom.scrub(BENCHMARK_SCRUB_BUDGET)) {
+    }
+    return eeprom.getScrubState();
+}
+
+static uint8_t *getStaticDataCopy(uint8_t index)
+{
+    return EEPROM.getData() + ArduinoEEPROM::staticDataOffset + index * (ArduinoEEPROM::staticDataLength / ArduinoEEPROM::staticDataCopies);
+}
+
+// each copy of the static data is corrupted and must be rewritten by the next pass. a copy with a stuck bit cannot
+// be repaired and must be reported. corrupted blocks in the wear leveling area must be counted, empty blocks and
+// blocks with valid data must not
+static void testScrub()
+{
+    static constexpr const char *name = "scrub";
+    format();
+    ArduinoEEPROM eeprom;
+    eeprom.begin();
+    StaticData_t staticData;
+    memset(staticData.data, 0x10, sizeof(staticData.data));
+    eeprom.writeStaticData(staticData);
+    uint8_t copy[ArduinoEEPROM::staticDataBlockSize];
+    memcpy(copy, getStaticDataCopy(0), sizeof(copy));
+
+    auto &state = scrubPass(eeprom);
+    if (state.staticDataRepaired || state.staticDataErrors || state.wearLevelErrors) {
+        error(name, 0, "errors reported after format");
+    }
+
+    // fill the wear leveling area
+    WearLevelData_t data;
+    uint32_t n;
+    for (n = 1; n <= ArduinoEEPROM::wearLevelNumBlocks / ArduinoEEPROM::wearLevelDataCopies; n++) {
+        setData(data, n);
+        eeprom.writeWearLevelData(data);
+    }
+
+    uint32_t repaired = 0;
+    for (uint8_t i = 0; i < ArduinoEEPROM::staticDataCopies; i++) {
+        getStaticDataCopy(i)[ArduinoEEPROM::dataBlockHeaderSize + (i % sizeof(staticData.data))] ^= 0xff;
+        scrubPass(eeprom);
+        if (state.staticDataRepaired != _BV(i) || state.staticDataErrors || memcmp(getStaticDataCopy(i), copy, sizeof(copy)) != 0) {
+            error(name, i, "static data has not been repaired");
+        }
+        else {
+            repaired++;
+        }
+        scrubPass(eeprom);
+        if (state.staticDataRepaired || state.staticDataErrors) {
+            error(name, i, "static data repaired twice");
+        }
+    }
+
+    // the stuck bit invalidates the last copy after rewriting it
+    uint8_t stuck = ArduinoEEPROM::staticDataCopies - 1;
+    EEPROM.setStuckBits(getStaticDataCopy(stuck) - EEPROM.getData() + ArduinoEEPROM::dataBlockHeaderSize, 0x01, 0x01);
+    scrubPass(eeprom);
+    StaticData_t result;
+    auto position = eeprom.readStaticData(result);
+    if (state.staticDataErrors != _BV(stuck) || state.staticDataRepaired || !position || (position & _BV(stuck)) || memcmp(&result, &staticData, sizeof(result)) != 0) {
+        error(name, stuck, "stuck bit in the static data has not been reported");
+    }
+
+    // every third block of the wear leveling area has an invalid CRC
+    uint32_t corrupted = 0;
+    ArduinoEEPROM::EEPROMSizeType lastOffset = ArduinoEEPROM::INVALID_OFFSET;
+    for (uint32_t i = 0; i < ArduinoEEPROM::wearLevelNumBlocks; i += 3) {
+        lastOffset = ArduinoEEPROM::wearLevelDataOffset + i * (ArduinoEEPROM::wearLevelDataLength / ArduinoEEPROM::wearLevelNumBlocks);
+        EEPROM.getData()[lastOffset + ArduinoEEPROM::dataBlockHeaderSize] ^= 0xff;
+        corrupted++;
+    }
+    scrubPass(eeprom);
+    if (state.wearLevelErrors != corrupted || state.lastErrorOffset != lastOffset) {
+        error(name, n, "invalid blocks have not been reported");
+    }
+    printf("%-12s static data repaired %u/%u, not repaired %02x, invalid blocks %u/%u, passes %u, errors %u\n", name, repaired, (unsigned)ArduinoEEPROM::staticDataCopies,
+        state.staticDataErrors, (unsigned)state.wearLevelErrors, corrupted, (unsigned)state.passes, _errors
+    );
+}
+
+#endif
+
+int main()
+{
+    printf("data size %u, block size %u, blocks %u, copies %u, bad blocks %u, endurance %u\n\n",
+        (unsigned)ArduinoEEPROM::wearLevelDataTypeSize, (unsigned)ArduinoEEPROM::wearLevelBlockSize, (unsigned)ArduinoEEPROM::wearLevelNumBlocks,
+        (unsigned)ArduinoEEPROM::wearLevelDataCopies, ARDUINO_EEPROM_HAVE_BAD_BLOCKS, BENCHMARK_FAULTS_ENDURANCE
+    );
+
+#if ARDUINO_EEPROM_HAVE_SCRUB
+    testScrub();
+#endif
+    testStuckBits();
+    testWornOut("worn out", writeSync);
+#if ARDUINO_EEPROM_HAVE_ASYNC_WRITE
+    testWornOut("async", writeAsync);
+#endif
+    return _errors ? 1 : 0;
+}
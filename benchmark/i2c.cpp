@@ -0,0 +1,133 @@
+/**
+ * Author: sascha_lammers@gmx.de
+ */
+
+// benchmark for external I2C EEPROMs using ArduinoEEPROMI2C and an emulated 24LC256 (64 byte pages, 5ms write
+// cycle) on an emulated 400kHz bus. reports the emulated time, bus transactions, ACK polls and write cycles for
+// initializing, writing, mounting and reading. the data is read back after each write operation and the
+// benchmark fails if it does not match or a page write rolled over
+//
+// requires BENCHMARK_I2C=1. ARDUINO_EEPROM_I2C_ACK_POLLING=0 and ARDUINO_EEPROM_I2C_BLOCK_ACCESS=0 can be used
+// to compare the results with single byte transactions and a fixed delay
+
+#include <Arduino.h>
+#include <Wire.h>
+#include <I2CEEPROM.h>
+#include "ArduinoEEPROM.h"
+
+#if !BENCHMARK_I2C
+#error BENCHMARK_I2C=1 required
+#endif
+
+#ifndef BENCHMARK_WRITES
+#define BENCHMARK_WRITES                                    1000UL
+#endif
+
+I2CEEPROMEmulator I2CDevice(0x50, BENCHMARK_I2C_SIZE, BENCHMARK_I2C_PAGE_SIZE);
+ArduinoEEPROMI2C I2CEEPROM(Wire, 0x50, BENCHMARK_I2C_SIZE, BENCHMARK_I2C_PAGE_SIZE);
+
+class I2CBenchmark {
+public:
+    void reset() {
+        _time = 0;
+        _transactions = 0;
+        _polls = 0;
+        _writeCycles = 0;
+    }
+
+    void start() {
+        _startTime = micros();
+        _startTransactions = Wire.getTransactions();
+        _startPolls = Wire.getNacks();
+        _startWriteCycles = I2CDevice.getWriteCycles();
+    }
+
+    void stop() {
+        _time += micros() - _startTime;
+        _polls += Wire.getNacks() - _startPolls;
+        _transactions += Wire.getTransactions() - _startTransactions;
+        _writeCycles += I2CDevice.getWriteCycles() - _startWriteCycles;
+    }
+
+    void print(const char *name, uint32_t count) {
+        printf("%-24s %10.2f %10.1f %10.1f %10.2f\n", name, _time / 1000.0 / count, (_transactions - _polls) / (double)count, _polls / (double)count, _writeCycles / (double)count);
+        reset();
+    }
+
+private:
+    uint32_t _time = 0;
+    uint32_t _transactions = 0;
+    uint32_t _polls = 0;
+    uint32_t _writeCycles = 0;
+    uint32_t _startTime;
+    uint32_t _startTransactions;
+    uint32_t _startPolls;
+    uint32_t _startWriteCycles;
+};
+
+int main()
+{
+    Wire.attach(I2CDevice);
+
+    printf("data size %u, block size %u, blocks %u, copies %u, burst size %u, ACK polling %u, block access %u\n\n",
+        (unsigned)ArduinoEEPROM::wearLevelDataTypeSize, (unsigned)ArduinoEEPROM::wearLevelBlockSize, (unsigned)ArduinoEEPROM::wearLevelNumBlocks,
+        (unsigned)ArduinoEEPROM::wearLevelDataCopies, (unsigned)ArduinoEEPROM::burstSize, ARDUINO_EEPROM_I2C_ACK_POLLING, ArduinoEEPROM::BlockAccess::hasBlockWrite
+    );
+    printf("%-24s %10s %10s %10s %10s\n", "operation", "ms/op", "bus/op", "polls/op", "cycles/op");
+
+    I2CBenchmark benchmark;
+    StaticData_t staticData = {};
+    WearLevelData_t data = {};
+    WearLevelData_t readData;
+    uint32_t errors = 0;
+
+    {
+        ArduinoEEPROM eeprom;
+        benchmark.start();
+        eeprom.eraseAndInitialize(ArduinoEEPROM::DataTypeEnum::ALL);
+        benchmark.stop();
+        benchmark.print("eraseAndInitialize", 1);
+
+        eeprom.begin();
+        benchmark.start();
+        if (eeprom.writeStaticData(staticData) == 0) {
+            errors++;
+        }
+        benchmark.stop();
+        benchmark.print("writeStaticData", 1);
+
+        for (uint32_t i = 0; i < BENCHMARK_WRITES; i++) {
+            for (uint8_t j = 0; j < sizeof(data.data); j++) {
+                data.data[j] = rand();
+            }
+            benchmark.start();
+            if (eeprom.writeWearLevelData(data) == 0) {
+                errors++;
+            }
+            benchmark.stop();
+            if (!eeprom.readWearLevelData(readData) || memcmp(&data, &readData, sizeof(data)) != 0) {
+                errors++;
+            }
+        }
+        benchmark.print("writeWearLevelData", BENCHMARK_WRITES);
+    }
+
+    {
+        // mount after reset
+        ArduinoEEPROM eeprom;
+        benchmark.start();
+        eeprom.begin();
+        benchmark.stop();
+        benchmark.print("begin", 1);
+
+        benchmark.start();
+        if (!eeprom.readWearLevelData(readData) || memcmp(&data, &readData, sizeof(data)) != 0) {
+            errors++;
+        }
+        benchmark.stop();
+        benchmark.print("readWearLevelData", 1);
+    }
+
+    printf("\nerrors %lu, rollovers %lu, max. writes per cell %lu\n", (unsigned long)errors, (unsigned long)I2CDevice.getRollovers(), (unsigned long)I2CDevice.getMaxWriteCount());
+    return (errors || I2CDevice.getRollovers()) ? 1 : 0;
+}
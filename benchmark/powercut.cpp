@@ -0,0 +1,217 @@
+/**
+ * Author: sascha_lammers@gmx.de
+ */
+
+// power cut test. cuts the power at every write operation of writeStaticData() and writeWearLevelData() with the
+// EEPROM emulator, mounts the EEPROM again and verifies that the new or the previous data can be read and that
+// the next write operation succeeds. the wear leveling data is tested at each position of the wear leveling area
+// with ARDUINO_EEPROM_HAVE_COUNTER=1, incrementCounter() is tested at each position of the log
+// returns an error if the data cannot be recovered
+
+#include <Arduino.h>
+#include <EEPROM.h>
+#include "ArduinoEEPROM.h"
+
+// number of writes of the wear leveling data that are interrupted, by default the area wraps around twice
+#ifndef BENCHMARK_POWER_CUT_ROUNDS
+#define BENCHMARK_POWER_CUT_ROUNDS                          ((ArduinoEEPROM::wearLevelNumBlocks / ArduinoEEPROM::wearLevelDataCopies) * 2 + 1)
+#endif
+
+struct PowerCut {
+};
+
+static void powerCut(EEPROMClass &)
+{
+    throw PowerCut();
+}
+
+class PowerCutTest {
+public:
+    PowerCutTest() : _snapshot(new uint8_t[EEPROM.length()]), _cuts(0), _previous(0), _errors(0) {
+    }
+
+    ~PowerCutTest() {
+        delete[] _snapshot;
+    }
+
+    template<class DataType, class WriteCallback, class ReadCallback>
+    void run(const char *name, uint32_t round, const DataType &data, const DataType &previous, bool hasPrevious, WriteCallback write, ReadCallback read) {
+        memcpy(_snapshot, EEPROM.getData(), EEPROM.length());
+        for (uint32_t cut = 0;; cut++) {
+            memcpy(EEPROM.getData(), _snapshot, EEPROM.length());
+            EEPROM.setPowerCut(cut, powerCut);
+            bool interrupted = false;
+            try {
+                ArduinoEEPROM eeprom;
+                eeprom.begin();
+                write(eeprom, data);
+            }
+            catch (PowerCut &) {
+                interrupted = true;
+                _cuts++;
+            }
+            EEPROM.powerOn();
+
+            // mount the EEPROM after the power cut
+            ArduinoEEPROM eeprom;
+            eeprom.begin();
+            DataType result;
+            if (!read(eeprom, result)) {
+                if (interrupted && !hasPrevious) {
+                    continue;
+                }
+                _error(name, round, cut, "cannot read data");
+            }
+            else if (memcmp(&result, &data, sizeof(data)) != 0) {
+                if (!interrupted || !hasPrevious || memcmp(&result, &previous, sizeof(previous)) != 0) {
+                    _error(name, round, cut, "invalid data");
+                }
+                _previous++;
+            }
+
+            // the next write operation must succeed
+            if (!write(eeprom, data) || !read(eeprom, result) || memcmp(&result, &data, sizeof(data)) != 0) {
+                _error(name, round, cut, "cannot write data");
+            }
+            // the EEPROM keeps the state of the last write operation without power cut
+            if (!interrupted) {
+                break;
+            }
+        }
+    }
+
+#if ARDUINO_EEPROM_HAVE_COUNTER
+    // the counter must have the previous or the incremented value after the power cut and must not lose any
+    // increment that has been completed
+    void runCounter(uint32_t round) {
+        const char *name = "counter";
+        memcpy(_snapshot, EEPROM.getData(), EEPROM.length());
+        uint32_t value;
+        {
+            ArduinoEEPROM eeprom;
+            eeprom.begin();
+            value = eeprom.readCounter();
+        }
+        for (uint32_t cut = 0;; cut++) {
+            memcpy(EEPROM.getData(), _snapshot, EEPROM.length());
+            EEPROM.setPowerCut(cut, powerCut);
+            bool interrupted = false;
+            try {
+                ArduinoEEPROM eeprom;
+                eeprom.begin();
+                eeprom.incrementCounter();
+            }
+            catch (PowerCut &) {
+                interrupted = true;
+                _cuts++;
+            }
+            EEPROM.powerOn();
+
+            ArduinoEEPROM eeprom;
+            eeprom.begin();
+            uint32_t result = eeprom.readCounter();
+            if (result != value + 1) {
+                if (!interrupted || result != value) {
+                    _error(name, round, cut, "invalid value");
+                }
+                _previous++;
+            }
+
+            // the next increment must succeed
+            if (!eeprom.incrementCounter()) {
+                _error(name, round, cut, "cannot increment");
+            }
+            ArduinoEEPROM mounted;
+            mounted.begin();
+            if (mounted.readCounter() != result + 1) {
+                _error(name, round, cut, "invalid value after increment");
+            }
+            if (!interrupted) {
+                break;
+            }
+        }
+    }
+#endif
+
+    uint32_t getCuts() const {
+        return _cuts;
+    }
+
+    uint32_t getPrevious() const {
+        return _previous;
+    }
+
+    uint32_t getErrors() const {
+        return _errors;
+    }
+
+private:
+    void _error(const char *name, uint32_t round, uint32_t cut, const char *message) {
+        if (_errors++ < 10) {
+            printf("ERROR: %s round %u, power cut after %u writes: %s\n", name, round, cut, message);
+        }
+    }
+
+    uint8_t *_snapshot;
+    uint32_t _cuts;
+    uint32_t _previous;
+    uint32_t _errors;
+};
+
+int main()
+{
+    printf("data size %u/%u, block size %u, blocks %u, copies %u/%u, commit marker %u, counter %u, %u rounds\n\n",
+        (unsigned)ArduinoEEPROM::staticDataTypeSize, (unsigned)ArduinoEEPROM::wearLevelDataTypeSize, (unsigned)ArduinoEEPROM::wearLevelBlockSize,
+        (unsigned)ArduinoEEPROM::wearLevelNumBlocks, (unsigned)ArduinoEEPROM::staticDataCopies, (unsigned)ArduinoEEPROM::wearLevelDataCopies,
+        ARDUINO_EEPROM_HAVE_COMMIT_MARKER, ARDUINO_EEPROM_HAVE_COUNTER, (unsigned)BENCHMARK_POWER_CUT_ROUNDS
+    );
+
+    EEPROM.clear();
+    EEPROM.setWriteLatency(0);
+    {
+        ArduinoEEPROM eeprom;
+        eeprom.begin();
+        eeprom.eraseAndInitialize(ArduinoEEPROM::DataTypeEnum::ALL);
+    }
+
+    PowerCutTest test;
+    StaticData_t staticData = {};
+    StaticData_t previousStaticData = {};
+    WearLevelData_t wearLevelData = {};
+    WearLevelData_t previousWearLevelData = {};
+
+    auto writeStaticData = [](ArduinoEEPROM &eeprom, const StaticData_t &data) {
+        return eeprom.writeStaticData(data) != 0;
+    };
+    auto readStaticData = [](ArduinoEEPROM &eeprom, StaticData_t &data) {
+        return eeprom.readStaticData(data) != 0;
+    };
+    auto writeWearLevelData = [](ArduinoEEPROM &eeprom, const WearLevelData_t &data) {
+        return eeprom.writeWearLevelData(data) != 0;
+    };
+    auto readWearLevelData = [](ArduinoEEPROM &eeprom, WearLevelData_t &data) {
+        return eeprom.readWearLevelData(data) != 0;
+    };
+
+    for (uint32_t round = 0; round < BENCHMARK_POWER_CUT_ROUNDS; round++) {
+        // all bytes are modified with each write
+        memset(staticData.data, round + 1, sizeof(staticData.data));
+        memset(wearLevelData.data, ~round, sizeof(wearLevelData.data));
+        if (round < 3) {
+            test.run("static data", round, staticData, previousStaticData, round != 0, writeStaticData, readStaticData);
+            previousStaticData = staticData;
+        }
+        test.run("wear leveling data", round, wearLevelData, previousWearLevelData, round != 0, writeWearLevelData, readWearLevelData);
+        previousWearLevelData = wearLevelData;
+    }
+
+#if ARDUINO_EEPROM_HAVE_COUNTER
+    // each round increments the counter twice, the log is reused 3 times
+    for (uint32_t round = 0; round < ArduinoEEPROM::counterLogSize * 3; round++) {
+        test.runCounter(round);
+    }
+#endif
+
+    printf("power cuts %u, previous data read %u, errors %u\n", test.getCuts(), test.getPrevious(), test.getErrors());
+    return test.getErrors() ? 1 : 0;
+}
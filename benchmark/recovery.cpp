@@ -0,0 +1,556 @@
+/**
+ * Author: sascha_lammers@gmx.de
+ */
+
+// recovery test for the optional data types with the EEPROM emulator. the data is written until the areas have
+// wrapped around several times and each write operation is interrupted by a power cut at every write of a single
+// byte. after each power cut, the EEPROM is mounted again and the new or the previous data must be readable. the
+// data is written again to verify the recovery
+// returns an error if the data cannot be recovered
+
+#include <Arduino.h>
+#include <EEPROM.h>
+#include "ArduinoEEPROM.h"
+
+struct PowerCut {
+};
+
+static uint8_t *_snapshot;
+static uint32_t _cuts;
+static uint32_t _errors;
+
+static uint32_t _random = 1;
+
+static uint8_t _rand()
+{
+    _random = _random * 1103515245UL + 12345;
+    return _random >> 16;
+}
+
+static void powerCut(EEPROMClass &)
+{
+    throw PowerCut();
+}
+
+static void error(const char *name, uint32_t round, const char *message)
+{
+    if (_errors++ < 10) {
+        printf("ERROR: %s round %u: %s\n", name, round, message);
+    }
+}
+
+static void format()
+{
+    EEPROM.clear();
+    EEPROM.setWriteLatency(0);
+    ArduinoEEPROM eeprom;
+    eeprom.begin();
+    eeprom.eraseAndInitialize(ArduinoEEPROM::DataTypeEnum::ALL);
+}
+
+// cut the power at each write operation of write(). after each power cut, the EEPROM is mounted again and
+// verify(eeprom, interrupted) is called. the EEPROM keeps the state of the write operation without power cut
+template<class WriteCallback, class VerifyCallback>
+static void powerCutSweep(WriteCallback write, VerifyCallback verify)
+{
+    memcpy(_snapshot, EEPROM.getData(), EEPROM.length());
+    for (uint32_t cut = 0;; cut++) {
+        memcpy(EEPROM.getData(), _snapshot, EEPROM.length());
+        EEPROM.setPowerCut(cut, powerCut);
+        bool interrupted = false;
+        try {
+            ArduinoEEPROM eeprom;
+            eeprom.begin();
+            write(eeprom);
+        }
+        catch (PowerCut &) {
+            interrupted = true;
+            _cuts++;
+        }
+        EEPROM.powerOn();
+
+        ArduinoEEPROM eeprom;
+        eeprom.begin();
+        verify(eeprom, interrupted);
+        if (!interrupted) {
+            break;
+        }
+    }
+}
+
+#if ARDUINO_EEPROM_HAVE_DELTA
+
+// 2-4 bytes are modified with each write. the patches are chained until the next snapshot and the wear leveling
+// area wraps around 3 times
+static void testDelta()
+{
+    static constexpr const char *name = "delta";
+    format();
+    WearLevelData_t data = {};
+    WearLevelData_t previous;
+    for (uint32_t round = 0; round < ArduinoEEPROM::wearLevelNumBlocks * 3 / ArduinoEEPROM::wearLevelDataCopies; round++) {
+        previous = data;
+        for (uint8_t i = 2 + _rand() % 3; i; i--) {
+            data.data[_rand() % sizeof(data.data)] = _rand();
+        }
+        powerCutSweep([&](ArduinoEEPROM &eeprom) {
+            eeprom.writeWearLevelData(data);
+        }, [&](ArduinoEEPROM &eeprom, bool interrupted) {
+            WearLevelData_t result;
+            if (!eeprom.readWearLevelData(result)) {
+                if (!interrupted || round != 0) {
+                    error(name, round, "cannot read data");
+                }
+            }
+            else if (memcmp(&result, &data, sizeof(data)) != 0 && (!interrupted || memcmp(&result, &previous, sizeof(previous)) != 0)) {
+                error(name, round, "invalid data");
+            }
+            if (interrupted) {
+                if (!eeprom.writeWearLevelData(data) || !eeprom.readWearLevelData(result) || memcmp(&result, &data, sizeof(data)) != 0) {
+                    error(name, round, "cannot write data");
+                }
+            }
+        });
+    }
+}
+
+#endif
+
+#if ARDUINO_EEPROM_HAVE_RECORD_STORE
+
+// records with random keys and lengths are written until the store has wrapped around 3 times. the live records
+// are carried forward with the first record written to a segment. the record of key 0 is written once and
+// carried forward by each segment
+static void testRecords()
+{
+    static constexpr const char *name = "records";
+    format();
+    uint8_t data[ArduinoEEPROM::recordMaxKeys][ArduinoEEPROM::recordMaxSize];
+    uint8_t length[ArduinoEEPROM::recordMaxKeys] = {};
+    for (uint32_t round = 0; round < ArduinoEEPROM::recordStoreLength * 3 / ArduinoEEPROM::recordHeaderSize; round++) {
+        uint8_t key = round ? 1 + (_rand() % (ArduinoEEPROM::recordMaxKeys - 1)) : 0;
+        uint8_t record[ArduinoEEPROM::recordMaxSize];
+        uint8_t recordLength = 1 + _rand() % ArduinoEEPROM::recordMaxSize;
+        for (uint8_t i = 0; i < recordLength; i++) {
+            record[i] = _rand();
+        }
+        powerCutSweep([&](ArduinoEEPROM &eeprom) {
+            eeprom.writeRecord(key, ConstByteAccessArray(record), recordLength);
+        }, [&](ArduinoEEPROM &eeprom, bool interrupted) {
+            uint8_t result[ArduinoEEPROM::recordMaxSize];
+            for (uint8_t i = 0; i < ArduinoEEPROM::recordMaxKeys; i++) {
+                auto resultLength = eeprom.readRecord(i, ByteAccessArray(result), sizeof(result));
+                if (i == key && resultLength == recordLength && memcmp(result, record, recordLength) == 0) {
+                    continue;
+                }
+                // the previous record of the key is valid if the power has been cut
+                if ((i != key || interrupted) && resultLength == length[i] && memcmp(result, data[i], length[i]) == 0) {
+                    continue;
+                }
+                error(name, round, "invalid record");
+            }
+            if (interrupted) {
+                if (!eeprom.writeRecord(key, ConstByteAccessArray(record), recordLength) || eeprom.readRecord(key, ByteAccessArray(result), sizeof(result)) != recordLength || memcmp(result, record, recordLength) != 0) {
+                    error(name, round, "cannot write record");
+                }
+            }
+        });
+        memcpy(data[key], record, recordLength);
+        length[key] = recordLength;
+    }
+}
+
+#endif
+
+#if ARDUINO_EEPROM_HAVE_HISTORY
+
+// returns the number of the record stored in the first 4 byte of the data
+static uint32_t getHistoryRecord(const WearLevelData_t &data)
+{
+    uint32_t record;
+    memcpy(&record, data.data, sizeof(record));
+    return record;
+}
+
+// read all records from the newest to the oldest one. the record numbers must be consecutive and each record must
+// be readable by its cycle id. returns the number of records read
+static uint32_t verifyHistory(const char *name, uint32_t round, ArduinoEEPROM &eeprom, uint32_t newest)
+{
+    ArduinoEEPROM::HistoryIterator_t iterator;
+    WearLevelData_t data;
+    WearLevelData_t copy;
+    uint32_t count = 0;
+    if (!eeprom.beginHistory(iterator)) {
+        error(name, round, "beginHistory() failed");
+        return 0;
+    }
+    while (eeprom.readHistory(iterator, data)) {
+        if (getHistoryRecord(data) != newest - count) {
+            error(name, round, "records are not consecutive");
+            return count;
+        }
+        if (!eeprom.readHistory(iterator.cycleId, copy) || memcmp(&data, &copy, sizeof(data)) != 0) {
+            error(name, round, "readHistory(cycleId) failed");
+        }
+        count++;
+    }
+    return count;
+}
+
+// write records with consecutive numbers until the wear leveling area has wrapped around 3 times and read the
+// history after each write. with delta records, records older than the oldest snapshot cannot be read
+static void testHistory()
+{
+    static constexpr const char *name = "history";
+    static constexpr uint32_t minRecords = (ArduinoEEPROM::wearLevelNumBlocks / ArduinoEEPROM::wearLevelDataCopies) - 1 - (ARDUINO_EEPROM_HAVE_DELTA ? ArduinoEEPROM::deltaSnapshotInterval : 0);
+    format();
+    WearLevelData_t data = {};
+    for (uint32_t round = 1; round <= ArduinoEEPROM::wearLevelNumBlocks * 3 / ArduinoEEPROM::wearLevelDataCopies; round++) {
+        memcpy(data.data, &round, sizeof(round));
+        powerCutSweep([&](ArduinoEEPROM &eeprom) {
+            eeprom.writeWearLevelData(data);
+        }, [&](ArduinoEEPROM &eeprom, bool interrupted) {
+            WearLevelData_t result;
+            uint32_t newest = round;
+            if (!eeprom.readWearLevelData(result)) {
+                if (!interrupted || round != 1) {
+                    error(name, round, "cannot read data");
+                }
+                return;
+            }
+            if (interrupted && getHistoryRecord(result) == round - 1) {
+                newest = round - 1;
+            }
+            auto count = verifyHistory(name, round, eeprom, newest);
+            if (count < min(newest, minRecords)) {
+                error(name, round, "records missing");
+            }
+        });
+    }
+}
+
+#endif
+
+#if ARDUINO_EEPROM_HAVE_TIME_SERIES
+
+struct Sample_t {
+    uint32_t number;
+    uint8_t data[ArduinoEEPROM::timeSeriesSampleSize - sizeof(uint32_t)];
+};
+
+static_assert(sizeof(Sample_t) == ArduinoEEPROM::timeSeriesSampleSize, "ARDUINO_EEPROM_TIME_SERIES_SAMPLE_SIZE must be 4 or more");
+
+// read all samples from the oldest to the newest one. the sample numbers and positions must be consecutive and
+// the newest sample must be newest. returns the number of samples read
+static uint32_t verifySamples(const char *name, uint32_t round, ArduinoEEPROM &eeprom, uint32_t newest)
+{
+    ArduinoEEPROM::TimeSeriesIterator_t iterator;
+    Sample_t sample;
+    uint32_t count = 0;
+    uint32_t number = 0;
+    uint32_t sequence = 0;
+    if (!eeprom.beginSamples(iterator)) {
+        if (newest) {
+            error(name, round, "beginSamples() failed");
+        }
+        return 0;
+    }
+    while (eeprom.readSample(iterator, sample)) {
+        if (count && (sample.number != number + 1 || iterator.sequence != sequence + 1)) {
+            error(name, round, "samples are not consecutive");
+            return count;
+        }
+        number = sample.number;
+        sequence = iterator.sequence;
+        count++;
+    }
+    if (count != eeprom.getNumSamples()) {
+        error(name, round, "getNumSamples() does not match");
+    }
+    if (count && number != newest) {
+        error(name, round, "newest sample missing");
+    }
+    return count;
+}
+
+// append samples with consecutive numbers until all pages have been overwritten 3 times. after each power cut,
+// the samples up to the new or the previous one must be readable
+static void testTimeSeries()
+{
+    static constexpr const char *name = "time series";
+    static constexpr uint32_t samplesPerCycle = ArduinoEEPROM::timeSeriesNumPages * ArduinoEEPROM::timeSeriesSamplesPerPage;
+    static constexpr uint32_t minSamples = samplesPerCycle - ArduinoEEPROM::timeSeriesSamplesPerPage;
+    format();
+    Sample_t sample = {};
+    for (uint32_t round = 1; round <= samplesPerCycle * 3; round++) {
+        sample.number = round;
+        // the oldest page is discarded if all pages are full
+        uint32_t expected;
+        {
+            ArduinoEEPROM eeprom;
+            eeprom.begin();
+            expected = eeprom.getNumSamples() + 1;
+            if (expected > samplesPerCycle) {
+                expected -= ArduinoEEPROM::timeSeriesSamplesPerPage;
+            }
+        }
+        powerCutSweep([&](ArduinoEEPROM &eeprom) {
+            eeprom.appendSample(sample);
+        }, [&](ArduinoEEPROM &eeprom, bool interrupted) {
+            uint32_t newest = round;
+            if (interrupted && eeprom.getNumSamples() != expected) {
+                newest = round - 1;
+            }
+            auto count = verifySamples(name, round, eeprom, newest);
+            if (count < min(newest, minSamples)) {
+                error(name, round, "samples missing");
+            }
+            if (interrupted) {
+                if (!eeprom.appendSample(sample) || verifySamples(name, round, eeprom, round) == 0) {
+                    error(name, round, "cannot append sample");
+                }
+            }
+        });
+    }
+
+#if ARDUINO_EEPROM_CYCLE_ID_BITS == 16
+    // continue until the cycle ids of the pages wrap around
+    ArduinoEEPROM eeprom;
+    eeprom.begin();
+    for (uint32_t round = samplesPerCycle * 3 + 1; round <= (ArduinoEEPROM::cycleIdMax + ArduinoEEPROM::timeSeriesNumPages) * ArduinoEEPROM::timeSeriesSamplesPerPage; round++) {
+        sample.number = round;
+        if (!eeprom.appendSample(sample)) {
+            error(name, round, "cannot append sample");
+            break;
+        }
+        if (round % ArduinoEEPROM::timeSeriesSamplesPerPage == 0 && verifySamples(name, round, eeprom, round) < minSamples) {
+            error(name, round, "samples missing");
+        }
+    }
+#endif
+}
+
+#endif
+
+#if ARDUINO_EEPROM_HAVE_EPOCH
+
+// max. number of bytes written by formatting the wear leveling area, a single epoch slot and the checkpoint slots
+#ifndef BENCHMARK_EPOCH_MAX_FORMAT_WRITES
+#define BENCHMARK_EPOCH_MAX_FORMAT_WRITES                   (ArduinoEEPROM::epochLength / ArduinoEEPROM::epochSlots + ArduinoEEPROM::checkpointLength)
+#endif
+
+// the wear leveling area is formatted repeatedly with a different number of records written in between, the
+// position of the latest block changes with each format. each format is interrupted by a power cut at every
+// write of a single byte. the wear leveling area must be formatted or unchanged and the next write operation
+// must succeed
+static void testEpoch()
+{
+    static constexpr const char *name = "epoch";
+    static constexpr uint32_t records = ArduinoEEPROM::wearLevelNumBlocks / ArduinoEEPROM::wearLevelDataCopies;
+    format();
+    WearLevelData_t data = {};
+    WearLevelData_t result;
+    uint32_t number = 0;
+    uint32_t maxFormatWrites = 0;
+    for (uint32_t round = 0; round < 10; round++) {
+        for (uint32_t i = (round * 7) % (records * 2); i; i--) {
+            number++;
+            memcpy(data.data, &number, sizeof(number));
+            ArduinoEEPROM eeprom;
+            eeprom.begin();
+            if (!eeprom.writeWearLevelData(data) || !eeprom.readWearLevelData(result) || memcmp(&result, &data, sizeof(data)) != 0) {
+                error(name, round, "cannot write data");
+            }
+        }
+
+        WearLevelData_t previous = data;
+        number++;
+        memcpy(data.data, &number, sizeof(number));
+        uint32_t formatWrites = 0;
+        powerCutSweep([&](ArduinoEEPROM &eeprom) {
+            auto writes = EEPROM.getWrites();
+            eeprom.eraseAndInitialize(ArduinoEEPROM::DataTypeEnum::WEAR_LEVEL_DATA);
+            formatWrites = EEPROM.getWrites() - writes;
+        }, [&](ArduinoEEPROM &eeprom, bool interrupted) {
+            // the blocks written before the format are empty
+            if (eeprom.readWearLevelData(result)) {
+                if (!interrupted) {
+                    error(name, round, "data readable after format");
+                }
+                else if (memcmp(&result, &previous, sizeof(previous)) != 0) {
+                    error(name, round, "invalid data");
+                }
+            }
+#if ARDUINO_EEPROM_HAVE_HISTORY
+            else {
+                ArduinoEEPROM::HistoryIterator_t iterator;
+                if (eeprom.beginHistory(iterator) && eeprom.readHistory(iterator, result)) {
+                    error(name, round, "history readable after format");
+                }
+            }
+#endif
+            // the cycle ids continue after the epoch
+            if (!eeprom.writeWearLevelData(data)) {
+                error(name, round, "cannot write data after format");
+            }
+            ArduinoEEPROM mounted;
+            mounted.begin();
+            if (!mounted.readWearLevelData(result) || memcmp(&result, &data, sizeof(data)) != 0) {
+                error(name, round, "cannot read data after format");
+            }
+        });
+        if (formatWrites > BENCHMARK_EPOCH_MAX_FORMAT_WRITES) {
+            error(name, round, "too many bytes written by the format");
+        }
+        maxFormatWrites = max(maxFormatWrites, formatWrites);
+    }
+    printf("%-12s max. bytes written by the format %u\n", name, maxFormatWrites);
+}
+
+#endif
+#if ARDUINO_EEPROM_HAVE_CHECKPOINT
+
+class ArduinoEEPROMBenchmark {
+public:
+    // returns true if the checkpoint is valid and rolling forward from it locates the block that has the highest
+    // cycle id in the wear leveling area
+    static bool isHeadFromCheckpoint(ArduinoEEPROM &eeprom) {
+        uint32_t cycleId;
+        uint32_t headCycleId = 0;
+        auto offset = eeprom._findWearLevelHeadOffsetFromCheckpoint(cycleId);
+        return offset != ArduinoEEPROM::INVALID_OFFSET && offset == eeprom._getWearLevelOffset(headCycleId) && cycleId == headCycleId;
+    }
+
+    // returns true if one of the checkpoint slots is valid
+    static bool hasCheckpoint(ArduinoEEPROM &eeprom) {
+        ArduinoEEPROM::Checkpoint_t checkpoint;
+        return eeprom._readCheckpoint(checkpoint) != ArduinoEEPROM::INVALID_CHECKPOINT;
+    }
+};
+
+// mount the EEPROM and verify that the latest block is located from a valid checkpoint and contains the data
+static void verifyHead(const char *name, uint32_t round, const WearLevelData_t &data, const char *message)
+{
+    ArduinoEEPROM eeprom;
+    eeprom.begin();
+    WearLevelData_t result;
+    if ((ArduinoEEPROMBenchmark::hasCheckpoint(eeprom) && !ArduinoEEPROMBenchmark::isHeadFromCheckpoint(eeprom)) || !eeprom.readWearLevelData(result) || memcmp(&result, &data, sizeof(data)) != 0) {
+        error(name, round, message);
+    }
+}
+
+// a checkpoint is written and the number of records written before restoring it increases with each round until
+// the wear leveling area has wrapped around twice. each byte of the checkpoint slots is corrupted and the write
+// operation of the checkpoint is interrupted by a power cut at every write of a single byte. rolling forward from
+// a valid checkpoint must locate the latest block and the next write operation must succeed
+static void testCheckpoint()
+{
+    static constexpr const char *name = "checkpoint";
+    static constexpr uint32_t records = ArduinoEEPROM::wearLevelNumBlocks / ArduinoEEPROM::wearLevelDataCopies;
+    format();
+    WearLevelData_t data = {};
+    uint32_t number = 0;
+    uint8_t checkpoint[ArduinoEEPROM::checkpointLength];
+    auto write = [&](uint32_t round) {
+        number++;
+        memcpy(data.data, &number, sizeof(number));
+        ArduinoEEPROM eeprom;
+        eeprom.begin();
+        if (!eeprom.writeWearLevelData(data)) {
+            error(name, round, "cannot write data");
+        }
+    };
+    write(0);
+    for (uint32_t round = 0; round < records * 2 + 2; round++) {
+        // the checkpoint is older than the records written after it
+        {
+            ArduinoEEPROM eeprom;
+            eeprom.begin();
+            if (!eeprom.writeCheckpoint()) {
+                error(name, round, "cannot write checkpoint");
+            }
+        }
+        memcpy(checkpoint, EEPROM.getData() + ArduinoEEPROM::checkpointOffset, sizeof(checkpoint));
+        for (uint32_t i = round; i; i--) {
+            write(round);
+        }
+        memcpy(EEPROM.getData() + ArduinoEEPROM::checkpointOffset, checkpoint, sizeof(checkpoint));
+        {
+            ArduinoEEPROM eeprom;
+            eeprom.begin();
+            if (!ArduinoEEPROMBenchmark::isHeadFromCheckpoint(eeprom)) {
+                error(name, round, "latest block not found from stale checkpoint");
+            }
+        }
+        verifyHead(name, round, data, "invalid data with stale checkpoint");
+
+        // one of the slots has an invalid CRC, the other slot is used if it is valid
+        for (uint8_t i = 0; i < sizeof(checkpoint); i++) {
+            EEPROM.getData()[ArduinoEEPROM::checkpointOffset + i] ^= 0x5a;
+            verifyHead(name, round, data, "invalid data with corrupt checkpoint");
+            EEPROM.getData()[ArduinoEEPROM::checkpointOffset + i] ^= 0x5a;
+        }
+
+        // the previous checkpoint remains valid until the new one has been written
+        WearLevelData_t next = data;
+        uint32_t nextNumber = number + 1;
+        memcpy(next.data, &nextNumber, sizeof(nextNumber));
+        powerCutSweep([&](ArduinoEEPROM &eeprom) {
+            eeprom.writeCheckpoint();
+        }, [&](ArduinoEEPROM &eeprom, bool interrupted) {
+            if (!ArduinoEEPROMBenchmark::isHeadFromCheckpoint(eeprom)) {
+                error(name, round, interrupted ? "latest block not found after power cut" : "latest block not found");
+            }
+            verifyHead(name, round, data, "invalid data after power cut");
+            if (!eeprom.writeWearLevelData(next)) {
+                error(name, round, "cannot write data after checkpoint");
+            }
+            verifyHead(name, round, next, "invalid data after checkpoint");
+        });
+        data = next;
+        number = nextNumber;
+    }
+}
+
+#endif
+
+int main()
+{
+    printf("data size %u, block size %u, blocks %u, copies %u, cycle id %u bit\n\n",
+        (unsigned)ArduinoEEPROM::wearLevelDataTypeSize, (unsigned)ArduinoEEPROM::wearLevelBlockSize, (unsigned)ArduinoEEPROM::wearLevelNumBlocks,
+        (unsigned)ArduinoEEPROM::wearLevelDataCopies, ARDUINO_EEPROM_CYCLE_ID_BITS
+    );
+
+    _snapshot = new uint8_t[EEPROM.length()];
+#if ARDUINO_EEPROM_HAVE_DELTA
+    testDelta();
+    printf("%-12s power cuts %u, errors %u\n", "delta", _cuts, _errors);
+#endif
+#if ARDUINO_EEPROM_HAVE_RECORD_STORE
+    _cuts = 0;
+    testRecords();
+    printf("%-12s power cuts %u, errors %u\n", "records", _cuts, _errors);
+#endif
+#if ARDUINO_EEPROM_HAVE_HISTORY
+    _cuts = 0;
+    testHistory();
+    printf("%-12s power cuts %u, errors %u\n", "history", _cuts, _errors);
+#endif
+#if ARDUINO_EEPROM_HAVE_TIME_SERIES
+    _cuts = 0;
+    testTimeSeries();
+    printf("%-12s power cuts %u, errors %u\n", "time series", _cuts, _errors);
+#endif
+#if ARDUINO_EEPROM_HAVE_EPOCH
+    _cuts = 0;
+    testEpoch();
+    printf("%-12s power cuts %u, errors %u\n", "epoch", _cuts, _errors);
+#endif
+#if ARDUINO_EEPROM_HAVE_CHECKPOINT
+    _cuts = 0;
+    testCheckpoint();
+    printf("%-12s power cuts %u, errors %u\n", "checkpoint", _cuts, _errors);
+#endif
+    delete[] _snapshot;
+    return _errors ? 1 : 0;
+}
@@ -0,0 +1,123 @@
+/**
+ * Author: sascha_lammers@gmx.de
+ */
+
+#include "Arduino.h"
+
+HardwareSerial Serial;
+
+static uint64_t _micros;
+
+uint32_t millis()
+{
+    return (uint32_t)(_micros / 1000);
+}
+
+uint32_t micros()
+{
+    return (uint32_t)_micros;
+}
+
+void delay(uint32_t ms)
+{
+    _micros += ms * 1000ULL;
+}
+
+void delayMicroseconds(uint32_t us)
+{
+    _micros += us;
+}
+
+void emulator_advance_micros(uint32_t us)
+{
+    _micros += us;
+}
+
+size_t Print::write(const uint8_t *buffer, size_t size)
+{
+    return fwrite(buffer, 1, size, stdout);
+}
+
+size_t Print::print(const char *str)
+{
+    return write(reinterpret_cast<const uint8_t *>(str), strlen(str));
+}
+
+size_t Print::print(const __FlashStringHelper *str)
+{
+    return print(reinterpret_cast<const char *>(str));
+}
+
+size_t Print::print(char ch)
+{
+    return write(reinterpret_cast<const uint8_t *>(&ch), 1);
+}
+
+size_t Print::print(unsigned long value, int base)
+{
+    return printf(base == 16 ? "%lx" : "%lu", value);
+}
+
+size_t Print::print(long value, int base)
+{
+    return base == 16 ? printf("%lx", value) : printf("%ld", value);
+}
+
+size_t Print::print(unsigned value, int base)
+{
+    return print((unsigned long)value, base);
+}
+
+size_t Print::print(int value, int base)
+{
+    return print((long)value, base);
+}
+
+size_t Print::print(double value, int digits)
+{
+    return printf("%.*f", digits, value);
+}
+
+size_t Print::println()
+{
+    return print("\n");
+}
+
+size_t Print::printf(const char *format, ...)
+{
+    char buf[256];
+    va_list arg;
+    va_start(arg, format);
+    int len = vsnprintf(buf, sizeof(buf), format, arg);
+    va_end(arg);
+    if (len < 0) {
+        return 0;
+    }
+    return write(reinterpret_cast<const uint8_t *>(buf), strlen(buf));
+}
+
+size_t Print::printf_P(PGM_P format, ...)
+{
+    char buf[256];
+    va_list arg;
+    va_start(arg, format);
+    int len = vsnprintf(buf, sizeof(buf), format, arg);
+    va_end(arg);
+    if (len < 0) {
+        return 0;
+    }
+    return write(reinterpret_cast<const uint8_t *>(buf), strlen(buf));
+}
+
+int Serial_printf_P(PGM_P format, ...)
+{
+    char buf[256];
+    va_list arg;
+    va_start(arg, format);
+    int len = vsnprintf(buf, sizeof(buf), format, arg);
+    va_end(arg);
+    if (len < 0) {
+        return 0;
+    }
+    return Serial.write(reinterpret_cast<const uint8_t *>(buf), strlen(buf));
+}
@@ -0,0 +1,87 @@
+/**
+ * Author: sascha_lammers@gmx.de
+ */
+
+#pragma once
+
+// minimal Arduino API to run the library on a host system together with the EEPROM emulator
+// the clock is emulated and advanced by delay() and EEPROM write operations
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdarg.h>
+#include <string.h>
+
+#define ARDUINO_EEPROM_EMULATOR                             1
+
+#ifndef ARDUINO
+#define ARDUINO                                             10810
+#endif
+
+// size of the emulated EEPROM
+#ifndef E2END
+#define E2END                                               0x3ff
+#endif
+
+#define PROGMEM
+#define PGM_P                                               const char *
+#define PSTR(str)                                           (str)
+#define F(str)                                              (reinterpret_cast<const __FlashStringHelper *>(str))
+#define pgm_read_byte(addr)                                 (*reinterpret_cast<const uint8_t *>(addr))
+#define pgm_read_word(addr)                                 (*reinterpret_cast<const uint16_t *>(addr))
+#define pgm_read_dword(addr)                                (*reinterpret_cast<const uint32_t *>(addr))
+#define memcpy_P                                            memcpy
+#define strcpy_P                                            strcpy
+#define snprintf_P                                          snprintf
+#define vsnprintf_P                                         vsnprintf
+
+class __FlashStringHelper;
+
+// emulated clock
+uint32_t millis();
+uint32_t micros();
+void delay(uint32_t ms);
+void delayMicroseconds(uint32_t us);
+
+// advance the emulated clock
+void emulator_advance_micros(uint32_t us);
+
+class Print {
+public:
+    size_t print(const char *str);
+    size_t print(const __FlashStringHelper *str);
+    size_t print(char ch);
+    size_t print(unsigned long value, int base = 10);
+    size_t print(long value, int base = 10);
+    size_t print(unsigned value, int base = 10);
+    size_t print(int value, int base = 10);
+    size_t print(double value, int digits = 2);
+    size_t println();
+
+    template<typename T>
+    size_t println(T value) {
+        return print(value) + println();
+    }
+
+    template<typename T>
+    size_t println(T value, int arg) {
+        return print(value, arg) + println();
+    }
+
+    size_t printf(const char *format, ...) __attribute__((format(printf, 2, 3)));
+    size_t printf_P(PGM_P format, ...) __attribute__((format(printf, 2, 3)));
+
+    virtual size_t write(const uint8_t *buffer, size_t size);
+};
+
+class HardwareSerial : public Print {
+public:
+    void begin(unsigned long) {}
+    void flush() {}
+};
+
+extern HardwareSerial Serial;
+
+int Serial_printf_P(PGM_P format, ...) __attribute__((format(printf, 1, 2)));
@@ -0,0 +1,241 @@
+/**
+ * Author: sascha_lammers@gmx.de
+ */
+
+#include "EEPROM.h"
+
+EEPROMClass EEPROM;
+
+EEPROMClass::EEPROMClass(uint32_t size) :
+    _size(size),
+    _data(new uint8_t[size]),
+    _writeCounts(new uint32_t[size]),
+    _stuckMask(new uint8_t[size]),
+    _stuckValue(new uint8_t[size]),
+    _latency(EEPROM_EMULATOR_WRITE_LATENCY)
+{
+    clear();
+}
+
+EEPROMClass::~EEPROMClass()
+{
+    delete[] _data;
+    delete[] _writeCounts;
+    delete[] _stuckMask;
+    delete[] _stuckValue;
+}
+
+uint8_t EEPROMClass::read(int address)
+{
+    if ((uint32_t)address >= _size) {
+        return 0xff;
+    }
+    _reads++;
+    _transactions++;
+    return (_data[address] & ~_stuckMask[address]) | (_stuckValue[address] & _stuckMask[address]);
+}
+
+void EEPROMClass::write(int address, uint8_t value)
+{
+    if ((uint32_t)address < _size) {
+        _write(address, value);
+    }
+}
+
+void EEPROMClass::update(int address, uint8_t value)
+{
+    if (read(address) != value) {
+        write(address, value);
+    }
+    else {
+        _skippedWrites++;
+    }
+}
+
+uint16_t EEPROMClass::length() const
+{
+    return (uint16_t)_size;
+}
+
+#if EEPROM_EMULATOR_BLOCK_ACCESS
+
+void EEPROMClass::read(uint32_t address, uint8_t *data, uint16_t length)
+{
+    _transactions++;
+    while (length--) {
+        if (address >= _size) {
+            *data++ = 0xff;
+            continue;
+        }
+        _reads++;
+        *data++ = (_data[address] & ~_stuckMask[address]) | (_stuckValue[address] & _stuckMask[address]);
+        address++;
+    }
+}
+
+void EEPROMClass::write(uint32_t address, const uint8_t *data, uint16_t length)
+{
+    if (!_beginWrite()) {
+        return;
+    }
+    _transactions++;
+    while (length-- && address < _size && _powerOn) {
+        _program(address++, *data++);
+    }
+}
+
+#endif
+
+bool EEPROMClass::isReady() const
+{
+    return (int32_t)(micros() - _busyUntil) >= 0;
+}
+
+void EEPROMClass::clear()
+{
+    memset(_data, 0xff, _size);
+    memset(_stuckMask, 0, _size);
+    memset(_stuckValue, 0, _size);
+    _endurance = 0;
+    _powerCut = 0;
+    _powerCutCallback = nullptr;
+    _powerOn = true;
+    _busyUntil = micros();
+    resetCounters();
+}
+
+void EEPROMClass::setWriteLatency(uint32_t latency)
+{
+    _latency = latency;
+}
+
+void EEPROMClass::resetCounters()
+{
+    memset(_writeCounts, 0, _size * sizeof(*_writeCounts));
+    _reads = 0;
+    _writes = 0;
+    _skippedWrites = 0;
+    _transactions = 0;
+    _writeTime = 0;
+}
+
+uint32_t EEPROMClass::getWriteCount(uint32_t address) const
+{
+    return address < _size ? _writeCounts[address] : 0;
+}
+
+uint32_t EEPROMClass::getMaxWriteCount() const
+{
+    uint32_t result = 0;
+    for (uint32_t i = 0; i < _size; i++) {
+        if (_writeCounts[i] > result) {
+            result = _writeCounts[i];
+        }
+    }
+    return result;
+}
+
+uint32_t EEPROMClass::getReads() const
+{
+    return _reads;
+}
+
+uint32_t EEPROMClass::getWrites() const
+{
+    return _writes;
+}
+
+uint32_t EEPROMClass::getSkippedWrites() const
+{
+    return _skippedWrites;
+}
+
+uint32_t EEPROMClass::getTransactions() const
+{
+    return _transactions;
+}
+
+uint64_t EEPROMClass::getWriteTime() const
+{
+    return _writeTime;
+}
+
+void EEPROMClass::setStuckBits(uint32_t address, uint8_t mask, uint8_t value)
+{
+    if (address < _size) {
+        _stuckMask[address] = mask;
+        _stuckValue[address] = value;
+    }
+}
+
+void EEPROMClass::setEndurance(uint32_t cycles)
+{
+    _endurance = cycles;
+}
+
+void EEPROMClass::setPowerCut(uint32_t writes, PowerCutCallback callback)
+{
+    _powerCut = writes + 1;
+    _powerCutCallback = callback;
+}
+
+void EEPROMClass::powerOn()
+{
+    _powerCut = 0;
+    _powerOn = true;
+}
+
+bool EEPROMClass::isPowerOn() const
+{
+    return _powerOn;
+}
+
+uint8_t *EEPROMClass::getData()
+{
+    return _data;
+}
+
+void EEPROMClass::_write(uint32_t address, uint8_t value)
+{
+    if (!_beginWrite()) {
+        return;
+    }
+    _transactions++;
+    _program(address, value);
+}
+
+bool EEPROMClass::_beginWrite()
+{
+    if (!_powerOn) {
+        return false;
+    }
+
+    // wait for the previous write operation
+    auto now = micros();
+    if ((int32_t)(now - _busyUntil) < 0) {
+        emulator_advance_micros(_busyUntil - now);
+    }
+    _busyUntil = micros() + _latency;
+    _writeTime += _latency;
+    return true;
+}
+
+void EEPROMClass::_program(uint32_t address, uint8_t value)
+{
+    _writes++;
+
+    if (_powerCut && --_powerCut == 0) {
+        // the cell has been erased but not written
+        _data[address] = 0xff;
+        _powerOn = false;
+        if (_powerCutCallback) {
+            _powerCutCallback(*this);
+        }
+        return;
+    }
+
+    if (++_writeCounts[address] > _endurance && _endurance) {
+        return;
+    }
+    _data[address] = value;
+}
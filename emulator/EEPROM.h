@@ -0,0 +1,131 @@
+/**
+ * Author: sascha_lammers@gmx.de
+ */
+
+#pragma once
+
+// EEPROM emulator with the interface of the Arduino EEPROMClass
+//
+// - write counter for each cell
+// - write latency, write operations wait until the previous one has been completed and advance the
+//   emulated clock. isReady() can be used for non-blocking writes
+// - fault injection: stuck bits, cells that stop working after a number of write cycles and power cuts
+// - optional block read and write methods like external EEPROMs, which are detected by ArduinoEEPROMBlockAccess
+
+#include <Arduino.h>
+
+// size of the default EEPROM object
+#ifndef EEPROM_EMULATOR_SIZE
+#define EEPROM_EMULATOR_SIZE                                (E2END + 1)
+#endif
+
+// write latency in microseconds, ~3.3ms for AVR
+#ifndef EEPROM_EMULATOR_WRITE_LATENCY
+#define EEPROM_EMULATOR_WRITE_LATENCY                       3300
+#endif
+
+// adds read(address, data, length) and write(address, data, length). a block is a single transaction and
+// written with the latency of a single write operation
+#ifndef EEPROM_EMULATOR_BLOCK_ACCESS
+#define EEPROM_EMULATOR_BLOCK_ACCESS                        0
+#endif
+
+class EEPROMClass {
+public:
+    using PowerCutCallback = void(*)(EEPROMClass &eeprom);
+
+    EEPROMClass(uint32_t size = EEPROM_EMULATOR_SIZE);
+    ~EEPROMClass();
+
+    uint8_t read(int address);
+    void write(int address, uint8_t value);
+    void update(int address, uint8_t value);
+    uint16_t length() const;
+
+#if EEPROM_EMULATOR_BLOCK_ACCESS
+    void read(uint32_t address, uint8_t *data, uint16_t length);
+    void write(uint32_t address, const uint8_t *data, uint16_t length);
+#endif
+
+    template<typename T>
+    T &get(int address, T &data) {
+        auto ptr = reinterpret_cast<uint8_t *>(&data);
+        for (size_t i = 0; i < sizeof(T); i++) {
+            *ptr++ = read(address++);
+        }
+        return data;
+    }
+
+    template<typename T>
+    const T &put(int address, const T &data) {
+        auto ptr = reinterpret_cast<const uint8_t *>(&data);
+        for (size_t i = 0; i < sizeof(T); i++) {
+            update(address++, *ptr++);
+        }
+        return data;
+    }
+
+    // returns true if the last write operation has been completed
+    bool isReady() const;
+
+    // erase all cells (0xff) and reset faults and counters
+    void clear();
+
+    // set write latency in microseconds
+    void setWriteLatency(uint32_t latency);
+
+    // statistics
+    void resetCounters();
+    uint32_t getWriteCount(uint32_t address) const;
+    uint32_t getMaxWriteCount() const;
+    uint32_t getReads() const;
+    uint32_t getWrites() const;
+    // number of update() calls that did not require writing
+    uint32_t getSkippedWrites() const;
+    // number of read and write transactions. a block counts as single transaction
+    uint32_t getTransactions() const;
+    // total time in microseconds spent writing
+    uint64_t getWriteTime() const;
+
+    // bits set in mask are stuck at the value of the bits in value
+    void setStuckBits(uint32_t address, uint8_t mask, uint8_t value);
+
+    // cells stop working after the number of write cycles and keep their last value. 0 disables it
+    void setEndurance(uint32_t cycles);
+
+    // cut power after the number of write operations. the cell that is being written is erased (0xff) and
+    // the callback is invoked, which can throw an exception or use longjmp() to stop the program. further
+    // write operations are ignored until powerOn() is called
+    void setPowerCut(uint32_t writes, PowerCutCallback callback = nullptr);
+    void powerOn();
+    bool isPowerOn() const;
+
+    // direct access to the memory without side effects
+    uint8_t *getData();
+
+private:
+    void _write(uint32_t address, uint8_t value);
+    // wait for the previous write operation and start a new one
+    // returns false if the power has been cut
+    bool _beginWrite();
+    void _program(uint32_t address, uint8_t value);
+
+    uint32_t _size;
+    uint8_t *_data;
+    uint32_t *_writeCounts;
+    uint8_t *_stuckMask;
+    uint8_t *_stuckValue;
+    uint32_t _reads;
+    uint32_t _writes;
+    uint32_t _skippedWrites;
+    uint32_t _transactions;
+    uint32_t _latency;
+    uint32_t _busyUntil;
+    uint64_t _writeTime;
+    uint32_t _endurance;
+    uint32_t _powerCut;
+    PowerCutCallback _powerCutCallback;
+    bool _powerOn;
+};
+
+extern EEPROMClass EEPROM;
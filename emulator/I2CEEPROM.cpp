@@ -0,0 +1,141 @@
+/**
+ * Author: sascha_lammers@gmx.de
+ */
+
+#include "I2CEEPROM.h"
+
+I2CEEPROMEmulator::I2CEEPROMEmulator(uint8_t address, uint32_t size, uint16_t pageSize, uint8_t addressBytes, uint32_t writeCycleTime) :
+    _address(address),
+    _blockMask((uint8_t)((size - 1) >> (8 * addressBytes))),
+    _addressBytes(addressBytes),
+    _pageSize(pageSize),
+    _size(size),
+    _writeCycleTime(writeCycleTime),
+    _pointer(0),
+    _data(new uint8_t[size]),
+    _writeCounts(new uint32_t[size])
+{
+    clear();
+}
+
+I2CEEPROMEmulator::~I2CEEPROMEmulator()
+{
+    delete[] _data;
+    delete[] _writeCounts;
+}
+
+bool I2CEEPROMEmulator::select(uint8_t address)
+{
+    if ((address & ~_blockMask) != _address) {
+        return false;
+    }
+    return !isBusy();
+}
+
+void I2CEEPROMEmulator::receive(uint8_t address, const uint8_t *data, size_t length)
+{
+    if (length < _addressBytes) {
+        // ACK polling or incomplete address
+        return;
+    }
+    _pointer = address & _blockMask;
+    for (uint8_t i = 0; i < _addressBytes; i++) {
+        _pointer = (_pointer << 8) | *data++;
+    }
+    _pointer %= _size;
+    length -= _addressBytes;
+    if (!length) {
+        // address for the next read operation
+        return;
+    }
+
+    // the address counter rolls over at the end of the page
+    uint32_t page = _pointer - (_pointer % _pageSize);
+    uint32_t position = _pointer - page;
+    for (size_t i = 0; i < length; i++) {
+        if (position + i >= _pageSize) {
+            _rollovers++;
+        }
+        uint32_t cell = page + ((position + i) % _pageSize);
+        _data[cell] = data[i];
+        _writeCounts[cell]++;
+    }
+    _bytesWritten += length;
+    _writeCycles++;
+    _busyUntil = micros() + _writeCycleTime;
+}
+
+void I2CEEPROMEmulator::transmit(uint8_t, uint8_t *data, size_t length)
+{
+    // sequential read, the address counter rolls over at the end of the memory
+    while (length--) {
+        *data++ = _data[_pointer];
+        _pointer = (_pointer + 1) % _size;
+    }
+}
+
+bool I2CEEPROMEmulator::isBusy() const
+{
+    return (int32_t)(micros() - _busyUntil) < 0;
+}
+
+void I2CEEPROMEmulator::clear()
+{
+    memset(_data, 0xff, _size);
+    _busyUntil = micros();
+    resetCounters();
+}
+
+void I2CEEPROMEmulator::resetCounters()
+{
+    memset(_writeCounts, 0, _size * sizeof(*_writeCounts));
+    _writeCycles = 0;
+    _bytesWritten = 0;
+    _rollovers = 0;
+}
+
+uint32_t I2CEEPROMEmulator::getWriteCount(uint32_t address) const
+{
+    return address < _size ? _writeCounts[address] : 0;
+}
+
+uint32_t I2CEEPROMEmulator::getMaxWriteCount() const
+{
+    uint32_t result = 0;
+    for (uint32_t i = 0; i < _size; i++) {
+        if (_writeCounts[i] > result) {
+            result = _writeCounts[i];
+        }
+    }
+    return result;
+}
+
+uint32_t I2CEEPROMEmulator::getWriteCycles() const
+{
+    return _writeCycles;
+}
+
+uint32_t I2CEEPROMEmulator::getBytesWritten() const
+{
+    return _bytesWritten;
+}
+
+uint32_t I2CEEPROMEmulator::getRollovers() const
+{
+    return _rollovers;
+}
+
+uint32_t I2CEEPROMEmulator::size() const
+{
+    return _size;
+}
+
+uint16_t I2CEEPROMEmulator::pageSize() const
+{
+    return _pageSize;
+}
+
+uint8_t *I2CEEPROMEmulator::getData()
+{
+    return _data;
+}
@@ -0,0 +1,64 @@
+/**
+ * Author: sascha_lammers@gmx.de
+ */
+
+#pragma once
+
+// emulated I2C EEPROM like the 24LC256, attached to the emulated bus with Wire.attach()
+//
+// - page writes roll over at the end of the page and overwrite the beginning of the same page
+// - the address is not acknowledged during the write cycle (ACK polling)
+// - addresses above the address bytes are selected with the lower bits of the device address (M24M02, 24LC16)
+// - write counter for each cell and number of write cycles
+
+#include <Arduino.h>
+#include <Wire.h>
+
+class I2CEEPROMEmulator : public TwoWireDevice {
+public:
+    // write cycle time in microseconds
+    I2CEEPROMEmulator(uint8_t address = 0x50, uint32_t size = 32768, uint16_t pageSize = 64, uint8_t addressBytes = 2, uint32_t writeCycleTime = 5000);
+    virtual ~I2CEEPROMEmulator();
+
+    virtual bool select(uint8_t address) override;
+    virtual void receive(uint8_t address, const uint8_t *data, size_t length) override;
+    virtual void transmit(uint8_t address, uint8_t *data, size_t length) override;
+
+    // returns true during the write cycle
+    bool isBusy() const;
+
+    // erase all cells (0xff) and reset counters
+    void clear();
+
+    // statistics
+    void resetCounters();
+    uint32_t getWriteCount(uint32_t address) const;
+    uint32_t getMaxWriteCount() const;
+    // number of page write operations
+    uint32_t getWriteCycles() const;
+    // number of bytes written
+    uint32_t getBytesWritten() const;
+    // number of bytes that rolled over to the beginning of the page
+    uint32_t getRollovers() const;
+
+    uint32_t size() const;
+    uint16_t pageSize() const;
+
+    // direct access to the memory without side effects
+    uint8_t *getData();
+
+private:
+    uint8_t _address;
+    uint8_t _blockMask;
+    uint8_t _addressBytes;
+    uint16_t _pageSize;
+    uint32_t _size;
+    uint32_t _writeCycleTime;
+    uint32_t _busyUntil;
+    uint32_t _pointer;
+    uint8_t *_data;
+    uint32_t *_writeCounts;
+    uint32_t _writeCycles;
+    uint32_t _bytesWritten;
+    uint32_t _rollovers;
+};
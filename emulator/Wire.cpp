@@ -0,0 +1,152 @@
+/**
+ * Author: sascha_lammers@gmx.de
+ */
+
+#include "Wire.h"
+
+TwoWire Wire;
+
+TwoWire::TwoWire() :
+    _devices(),
+    _clock(EMULATOR_I2C_CLOCK),
+    _transactions(0),
+    _nacks(0),
+    _txLength(0),
+    _txOverflow(false),
+    _rxLength(0),
+    _rxPosition(0)
+{
+}
+
+void TwoWire::setClock(uint32_t clock)
+{
+    _clock = clock;
+}
+
+void TwoWire::attach(TwoWireDevice &device)
+{
+    for (auto &ptr : _devices) {
+        if (!ptr) {
+            ptr = &device;
+            return;
+        }
+    }
+}
+
+void TwoWire::detach(TwoWireDevice &device)
+{
+    for (auto &ptr : _devices) {
+        if (ptr == &device) {
+            ptr = nullptr;
+        }
+    }
+}
+
+void TwoWire::beginTransmission(uint8_t address)
+{
+    _address = address;
+    _txLength = 0;
+    _txOverflow = false;
+}
+
+size_t TwoWire::write(uint8_t data)
+{
+    if (_txLength >= BUFFER_LENGTH) {
+        _txOverflow = true;
+        return 0;
+    }
+    _txBuffer[_txLength++] = data;
+    return 1;
+}
+
+size_t TwoWire::write(const uint8_t *data, size_t length)
+{
+    for (size_t i = 0; i < length; i++) {
+        if (!write(data[i])) {
+            return i;
+        }
+    }
+    return length;
+}
+
+uint8_t TwoWire::endTransmission(bool)
+{
+    if (_txOverflow) {
+        return 1;
+    }
+    _transactions++;
+    auto device = _select(_address);
+    if (!device) {
+        _nacks++;
+        _transfer(0);
+        return 2;
+    }
+    _transfer(_txLength);
+    device->receive(_address, _txBuffer, _txLength);
+    return 0;
+}
+
+uint8_t TwoWire::requestFrom(uint8_t address, uint8_t quantity, bool)
+{
+    _rxLength = 0;
+    _rxPosition = 0;
+    if (quantity > BUFFER_LENGTH) {
+        quantity = BUFFER_LENGTH;
+    }
+    _transactions++;
+    auto device = _select(address);
+    if (!device) {
+        _nacks++;
+        _transfer(0);
+        return 0;
+    }
+    _transfer(quantity);
+    device->transmit(address, _rxBuffer, quantity);
+    _rxLength = quantity;
+    return quantity;
+}
+
+int TwoWire::available()
+{
+    return _rxLength - _rxPosition;
+}
+
+int TwoWire::read()
+{
+    if (_rxPosition >= _rxLength) {
+        return -1;
+    }
+    return _rxBuffer[_rxPosition++];
+}
+
+void TwoWire::resetCounters()
+{
+    _transactions = 0;
+    _nacks = 0;
+}
+
+uint32_t TwoWire::getTransactions() const
+{
+    return _transactions;
+}
+
+uint32_t TwoWire::getNacks() const
+{
+    return _nacks;
+}
+
+TwoWireDevice *TwoWire::_select(uint8_t address)
+{
+    for (auto device : _devices) {
+        if (device && device->select(address)) {
+            return device;
+        }
+    }
+    return nullptr;
+}
+
+void TwoWire::_transfer(size_t length)
+{
+    // 9 clock cycles per byte, 2 for start and stop
+    emulator_advance_micros((uint32_t)((((length + 1) * 9 + 2) * 1000000ULL) / _clock));
+}
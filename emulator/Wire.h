@@ -0,0 +1,84 @@
+/**
+ * Author: sascha_lammers@gmx.de
+ */
+
+#pragma once
+
+// emulated I2C bus with the interface of the Arduino TwoWire class
+//
+// - devices are attached with Wire.attach()
+// - each transaction advances the emulated clock by the time required to transfer the bytes
+// - the buffer is limited to BUFFER_LENGTH bytes like the AVR implementation
+
+#include <Arduino.h>
+
+#ifndef BUFFER_LENGTH
+#define BUFFER_LENGTH                                       32
+#endif
+
+// clock of the I2C bus in Hz
+#ifndef EMULATOR_I2C_CLOCK
+#define EMULATOR_I2C_CLOCK                                  400000UL
+#endif
+
+#ifndef EMULATOR_I2C_MAX_DEVICES
+#define EMULATOR_I2C_MAX_DEVICES                            4
+#endif
+
+class TwoWireDevice {
+public:
+    virtual ~TwoWireDevice() {}
+
+    // returns true if the device acknowledges the address
+    virtual bool select(uint8_t address) = 0;
+    // data written to the device with a single transaction
+    virtual void receive(uint8_t address, const uint8_t *data, size_t length) = 0;
+    // data requested by the master
+    virtual void transmit(uint8_t address, uint8_t *data, size_t length) = 0;
+};
+
+class TwoWire {
+public:
+    TwoWire();
+
+    void begin() {}
+    void setClock(uint32_t clock);
+
+    void attach(TwoWireDevice &device);
+    void detach(TwoWireDevice &device);
+
+    void beginTransmission(uint8_t address);
+    size_t write(uint8_t data);
+    size_t write(const uint8_t *data, size_t length);
+    // returns 0 on success, 1 data too long, 2 NACK on address
+    uint8_t endTransmission(bool sendStop = true);
+    uint8_t requestFrom(uint8_t address, uint8_t quantity, bool sendStop = true);
+    int available();
+    int read();
+
+    // statistics
+    void resetCounters();
+    // number of transactions including NACKs
+    uint32_t getTransactions() const;
+    // number of transactions that were not acknowledged
+    uint32_t getNacks() const;
+
+private:
+    TwoWireDevice *_select(uint8_t address);
+    // advance the emulated clock, start, address and data bytes with ACK and stop
+    void _transfer(size_t length);
+
+    TwoWireDevice *_devices[EMULATOR_I2C_MAX_DEVICES];
+    uint32_t _clock;
+    uint32_t _transactions;
+    uint32_t _nacks;
+    uint8_t _address;
+    uint8_t _txBuffer[BUFFER_LENGTH];
+    uint8_t _txLength;
+    bool _txOverflow;
+    uint8_t _rxBuffer[BUFFER_LENGTH];
+    uint8_t _rxLength;
+    uint8_t _rxPosition;
+};
+
+extern TwoWire Wire;
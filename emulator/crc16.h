@@ -0,0 +1,38 @@
+/**
+ * Author: sascha_lammers@gmx.de
+ */
+
+#pragma once
+
+// CRC-16 functions of libcrc16 for the host system. polynomial 0xa001, same as _crc16_update() from avr-libc
+
+#include <stdint.h>
+#include <stddef.h>
+
+inline uint16_t _crc16_update(uint16_t crc, uint8_t a)
+{
+    crc ^= a;
+    for (uint8_t i = 0; i < 8; i++) {
+        crc = (crc & 1) ? ((crc >> 1) ^ 0xa001) : (crc >> 1);
+    }
+    return crc;
+}
+
+inline uint16_t crc16_update(uint16_t crc, uint8_t a)
+{
+    return _crc16_update(crc, a);
+}
+
+inline uint16_t crc16_update(uint16_t crc, const void *data, size_t len)
+{
+    auto ptr = reinterpret_cast<const uint8_t *>(data);
+    while (len--) {
+        crc = _crc16_update(crc, *ptr++);
+    }
+    return crc;
+}
+
+inline uint16_t crc16_update(const void *data, size_t len)
+{
+    return crc16_update(~0, data, len);
+}
@@ -0,0 +1,23 @@
+/**
+ * Author: sascha_lammers@gmx.de
+ */
+
+#include <Arduino.h>
+
+// runs an Arduino sketch on the host system
+
+#ifndef EMULATOR_LOOP_COUNT
+#define EMULATOR_LOOP_COUNT                                 10
+#endif
+
+void setup();
+void loop();
+
+int main()
+{
+    setup();
+    for (uint32_t i = 0; i < EMULATOR_LOOP_COUNT; i++) {
+        loop();
+    }
+    return 0;
+}
@@ -7,7 +7,8 @@
 #include <Arduino.h>
 #include <EEPROM.h>
 #include <arduino_eeprom_config.h>
-#include "crc16.h"
+#include "ArduinoEEPROMCrc.h"
+#include "ArduinoEEPROMBlockAccess.h"
 #include "ByteAccessInterface.h"
 
 // supports any type of EEPROM that is organized in single bytes or words
@@ -57,6 +58,26 @@
 #define ARDUINO_EEPROM_WEAR_LEVEL_DATA_NUM_COPIES           2
 #endif
 
+// max. number of copies or previously stored data that readWearLevelData() tries to read
+// the candidates are collected in a single scan and stored on the stack (6 byte per copy)
+#ifndef ARDUINO_EEPROM_WEAR_LEVEL_MAX_READ_COPIES
+#define ARDUINO_EEPROM_WEAR_LEVEL_MAX_READ_COPIES           8
+#endif
+#if ARDUINO_EEPROM_WEAR_LEVEL_MAX_READ_COPIES < 1
+#error At least 1 required
+#endif
+
+// default commit policy of ArduinoEEPROMWriteBackTpl
+// max. number of updates kept in RAM before the data is written, 0 = unlimited
+#ifndef ARDUINO_EEPROM_WRITE_BACK_MAX_UPDATES
+#define ARDUINO_EEPROM_WRITE_BACK_MAX_UPDATES               100
+#endif
+
+// max. time in milliseconds before modified data is written, 0 = unlimited
+#ifndef ARDUINO_EEPROM_WRITE_BACK_MAX_AGE
+#define ARDUINO_EEPROM_WRITE_BACK_MAX_AGE                   60000UL
+#endif
+
 #ifndef ARDUINO_EEPROM_WRITE_ERROR_RETRIES
 #define ARDUINO_EEPROM_WRITE_ERROR_RETRIES                  3
 #endif
@@ -94,10 +115,13 @@
 
 #endif
 
+// type for offsets and sizes. EEPROMs with more than 64KB use 32 bit
 #if (ARDUINO_EEPROM_LENGTH + ARDUINO_EEPROM_START_OFFSET) <= 255
 typedef uint8_t eeprom_size_t;
-#else
+#elif ARDUINO_EEPROM_MAX_LENGTH <= 0xffff
 typedef uint16_t eeprom_size_t;
+#else
+typedef uint32_t eeprom_size_t;
 #endif
 
 #ifndef ARDUINO_EEPROM_STATIC_DATA_TYPE
@@ -134,6 +158,208 @@ typedef uint16_t eeprom_size_t;
 #error Microsoft Visual Studio required
 #endif
 
+// adds a commit marker to the header of each block that is derived from the cycle id. the header of a block
+// is written after its payload and the commit marker is the last byte. if a write operation gets interrupted,
+// the block can be identified as invalid without reading the payload and validating the CRC
+// changes the layout of the EEPROM, 1 extra byte per block
+#ifndef ARDUINO_EEPROM_HAVE_COMMIT_MARKER
+#define ARDUINO_EEPROM_HAVE_COMMIT_MARKER                   0
+#endif
+
+// size of the cycle id in the header of each block, 16, 24 or 32 bit. with less than 32 bit, the cycle ids wrap
+// around and are compared relative to each other. the number of blocks in the wear leveling area must be less
+// than half of the cycle ids. changes the layout of the EEPROM
+#ifndef ARDUINO_EEPROM_CYCLE_ID_BITS
+#define ARDUINO_EEPROM_CYCLE_ID_BITS                        32
+#endif
+#if ARDUINO_EEPROM_CYCLE_ID_BITS != 16 && ARDUINO_EEPROM_CYCLE_ID_BITS != 24 && ARDUINO_EEPROM_CYCLE_ID_BITS != 32
+#error 16, 24 or 32 bit required
+#endif
+
+// size of the CRC in the header of each block, 8 or 16 bit. 8 bit uses CRC-8 with the polynomial 0x07 for
+// small blocks. changes the layout of the EEPROM
+#ifndef ARDUINO_EEPROM_HEADER_CRC_BITS
+#define ARDUINO_EEPROM_HEADER_CRC_BITS                      16
+#endif
+#if ARDUINO_EEPROM_HEADER_CRC_BITS != 8 && ARDUINO_EEPROM_HEADER_CRC_BITS != 16
+#error 8 or 16 bit required
+#endif
+
+// stores the position of a recent block of the wear leveling area in two alternating slots in front of the
+// static data. begin() verifies it and rolls forward to the latest block instead of searching the whole area
+// the checkpoint is updated after every ARDUINO_EEPROM_CHECKPOINT_INTERVAL wraps of the wear leveling area
+// and by writeCheckpoint(). changes the layout of the EEPROM
+#ifndef ARDUINO_EEPROM_HAVE_CHECKPOINT
+#define ARDUINO_EEPROM_HAVE_CHECKPOINT                      0
+#endif
+
+#ifndef ARDUINO_EEPROM_CHECKPOINT_INTERVAL
+#define ARDUINO_EEPROM_CHECKPOINT_INTERVAL                  1
+#endif
+#if ARDUINO_EEPROM_CHECKPOINT_INTERVAL < 1
+#error At least 1 required
+#endif
+
+// eraseAndInitialize() formats the wear leveling area by storing the highest cycle id as epoch instead of writing
+// every block. blocks with a cycle id less or equal to the epoch and erased blocks (0xff) are empty. the epoch is
+// stored in two alternating slots in front of the static data and read by begin(). changes the layout of the EEPROM
+#ifndef ARDUINO_EEPROM_HAVE_EPOCH
+#define ARDUINO_EEPROM_HAVE_EPOCH                           0
+#endif
+
+// if the epoch exceeds this value, the cycle ids are reset by writing every block
+#ifndef ARDUINO_EEPROM_EPOCH_MAX_CYCLE_ID
+#define ARDUINO_EEPROM_EPOCH_MAX_CYCLE_ID                   0x80000000UL
+#endif
+#if ARDUINO_EEPROM_HAVE_EPOCH && ARDUINO_EEPROM_CYCLE_ID_BITS != 32
+#error The epoch requires 32 bit cycle ids
+#endif
+
+// non-blocking writes. writeStaticDataAsync() and writeWearLevelDataAsync() copy the data into a buffer and
+// poll() writes one byte each time the EEPROM is ready
+#ifndef ARDUINO_EEPROM_HAVE_ASYNC_WRITE
+#define ARDUINO_EEPROM_HAVE_ASYNC_WRITE                     0
+#endif
+
+// keeps a bitmap of blocks in the wear leveling area that could not be written. these blocks are skipped and if
+// writing a block fails, the next block is used instead of retrying ARDUINO_EEPROM_WRITE_ERROR_RETRIES times. the
+// bitmap is stored in two copies in front of the static data and read by begin(). requires 1 bit RAM per block
+// changes the layout of the EEPROM
+#ifndef ARDUINO_EEPROM_HAVE_BAD_BLOCKS
+#define ARDUINO_EEPROM_HAVE_BAD_BLOCKS                      0
+#endif
+
+// counter region for a monotonically increasing 32 bit value. an increment writes a marker to the next byte of a
+// log of ARDUINO_EEPROM_COUNTER_LOG_SIZE bytes. an interrupted write operation does not affect previous increments.
+// when all bytes have been written, the value is stored in one of two checkpoint slots and the log is reused with
+// the other marker without erasing it. changes the layout of the EEPROM
+#ifndef ARDUINO_EEPROM_HAVE_COUNTER
+#define ARDUINO_EEPROM_HAVE_COUNTER                         0
+#endif
+
+#ifndef ARDUINO_EEPROM_COUNTER_LOG_SIZE
+#define ARDUINO_EEPROM_COUNTER_LOG_SIZE                     32
+#endif
+
+#if ARDUINO_EEPROM_COUNTER_LOG_SIZE < 1 || ARDUINO_EEPROM_COUNTER_LOG_SIZE > 255
+#error Counter log size must be 1-255
+#endif
+
+// log structured store for records that are updated independently. each record is tagged with a key from 0 to
+// ARDUINO_EEPROM_RECORD_MAX_KEYS - 1 and appended to the current segment of the store. begin() scans the store once
+// and keeps the offset of the latest record of each key in RAM. when a segment becomes the current segment, the
+// latest records of the segment following it are copied forward. a segment must hold one record per key plus one
+// additional record with ARDUINO_EEPROM_RECORD_MAX_SIZE byte. requires 2-4 byte RAM per key. changes the layout
+// of the EEPROM
+#ifndef ARDUINO_EEPROM_HAVE_RECORD_STORE
+#define ARDUINO_EEPROM_HAVE_RECORD_STORE                    0
+#endif
+
+#ifndef ARDUINO_EEPROM_RECORD_MAX_KEYS
+#define ARDUINO_EEPROM_RECORD_MAX_KEYS                      4
+#endif
+#if ARDUINO_EEPROM_RECORD_MAX_KEYS < 1 || ARDUINO_EEPROM_RECORD_MAX_KEYS > 255
+#error Number of keys must be 1-255
+#endif
+
+// max. size of a record without header
+#ifndef ARDUINO_EEPROM_RECORD_MAX_SIZE
+#define ARDUINO_EEPROM_RECORD_MAX_SIZE                      16
+#endif
+#if ARDUINO_EEPROM_RECORD_MAX_SIZE < 1 || ARDUINO_EEPROM_RECORD_MAX_SIZE > 255
+#error Record size must be 1-255
+#endif
+
+#ifndef ARDUINO_EEPROM_RECORD_SEGMENT_SIZE
+#define ARDUINO_EEPROM_RECORD_SEGMENT_SIZE                  128
+#endif
+
+// size of the store, at least 2 segments
+#ifndef ARDUINO_EEPROM_RECORD_STORE_SIZE
+#define ARDUINO_EEPROM_RECORD_STORE_SIZE                    (4 * ARDUINO_EEPROM_RECORD_SEGMENT_SIZE)
+#endif
+
+// append only region for small samples of fixed size. the samples are packed into pages with a single header that
+// is written when the page is started. each sample is followed by a marker byte that is written after the sample,
+// which marks it as valid. an interrupted write operation does not affect other samples. begin() locates the latest
+// page and counts its samples. the marker alternates with each cycle of the pages, so the markers of the previous
+// cycle do not have to be cleared. the samples are not covered by a CRC. requires 8-12 byte RAM. changes the layout
+// of the EEPROM
+#ifndef ARDUINO_EEPROM_HAVE_TIME_SERIES
+#define ARDUINO_EEPROM_HAVE_TIME_SERIES                     0
+#endif
+
+#ifndef ARDUINO_EEPROM_TIME_SERIES_SAMPLE_SIZE
+#define ARDUINO_EEPROM_TIME_SERIES_SAMPLE_SIZE              4
+#endif
+#if ARDUINO_EEPROM_TIME_SERIES_SAMPLE_SIZE < 1 || ARDUINO_EEPROM_TIME_SERIES_SAMPLE_SIZE > 255
+#error Sample size must be 1-255
+#endif
+
+// size of a page including the header
+#ifndef ARDUINO_EEPROM_TIME_SERIES_PAGE_SIZE
+#define ARDUINO_EEPROM_TIME_SERIES_PAGE_SIZE                64
+#endif
+
+// size of the region, at least 2 pages
+#ifndef ARDUINO_EEPROM_TIME_SERIES_SIZE
+#define ARDUINO_EEPROM_TIME_SERIES_SIZE                     (4 * ARDUINO_EEPROM_TIME_SERIES_PAGE_SIZE)
+#endif
+
+// stores the wear leveling data as patch against the previous data if only a few bytes have been modified. a patch
+// contains a bitmap of the modified bytes and their values. the complete data is stored after
+// ARDUINO_EEPROM_DELTA_SNAPSHOT_INTERVAL - 1 patches or if the patch is not smaller than the data. readWearLevelData()
+// reads the latest snapshot and applies the following patches. adds 1 byte per block and writing requires about
+// 3 * ARDUINO_EEPROM_WEAR_LEVEL_DATA_SIZE byte stack. changes the layout of the EEPROM
+#ifndef ARDUINO_EEPROM_HAVE_DELTA
+#define ARDUINO_EEPROM_HAVE_DELTA                           0
+#endif
+
+// max. number of records from a snapshot to the latest patch. reading stores the offset of each record on the stack
+#ifndef ARDUINO_EEPROM_DELTA_SNAPSHOT_INTERVAL
+#define ARDUINO_EEPROM_DELTA_SNAPSHOT_INTERVAL              8
+#endif
+#if ARDUINO_EEPROM_DELTA_SNAPSHOT_INTERVAL < 1 || ARDUINO_EEPROM_DELTA_SNAPSHOT_INTERVAL > 255
+#error Snapshot interval must be 1-255
+#endif
+
+// incremental check of the EEPROM. scrub() validates a limited number of blocks per call and continues at the
+// position where the previous call stopped. outdated or corrupted copies of the static data are rewritten from
+// a valid copy and bad blocks in the wear leveling area are counted. requires 14-20 byte RAM
+#ifndef ARDUINO_EEPROM_HAVE_SCRUB
+#define ARDUINO_EEPROM_HAVE_SCRUB                           0
+#endif
+
+// read previous records of the wear leveling data. the blocks are written in sequence and the cycle id increases by
+// one for each block, including bad blocks. the offset of a cycle id is calculated from the latest block and
+// readHistory() walks from the newest to the oldest record without scanning the wear leveling area
+#ifndef ARDUINO_EEPROM_HAVE_HISTORY
+#define ARDUINO_EEPROM_HAVE_HISTORY                         0
+#endif
+
+// returns true if the EEPROM can accept the next write operation. evaluated inside ArduinoEEPROMBase,
+// _eeprom is the EEPROM object
+#ifndef ARDUINO_EEPROM_IS_READY
+#if defined(__AVR__)
+#define ARDUINO_EEPROM_IS_READY()                           eeprom_is_ready()
+#elif ARDUINO_EEPROM_EMULATOR
+#define ARDUINO_EEPROM_IS_READY()                           _eeprom.isReady()
+#else
+#define ARDUINO_EEPROM_IS_READY()                           true
+#endif
+#endif
+
+// max. number of bytes transferred at once if the EEPROM class supports reading and writing blocks
+// (see ArduinoEEPROMBlockAccess.h). the data is stored on the stack and write operations are aligned to the
+// burst size and do not cross page boundaries. it must be a divisor of the page size of the EEPROM
+// Wire has a 32 byte buffer including the address
+#ifndef ARDUINO_EEPROM_BURST_SIZE
+#define ARDUINO_EEPROM_BURST_SIZE                           16
+#endif
+#if ARDUINO_EEPROM_BURST_SIZE < 1 || ARDUINO_EEPROM_BURST_SIZE > 255
+#error Burst size must be 1-255
+#endif
+
 #define ARDUINO_EEPROM_ALIGN_ADDR(address)                  (((address + pageSize - 1) / pageSize) * pageSize)
 #define ARDUINO_EEPROM_ALIGN_LEN(len)                       ARDUINO_EEPROM_ALIGN_ADDR(len)
 
@@ -143,7 +369,7 @@ typedef uint16_t eeprom_size_t;
 #endif
 
 #ifndef _BV
-#define _BV(bit)                                            (1<<bit)
+#define _BV(bit)                                            (1<<(bit))
 #endif
 
 #ifndef max
@@ -167,16 +393,37 @@ public:
     using EEPROMClass = ARDUINO_EEPROM_CLASS;
     using EEPROMSizeType = eeprom_size_t;
     using CRCType = uint16_t;
+    using CRC = ArduinoEEPROMCrc16<ARDUINO_EEPROM_CRC_ENGINE>;
+#if ARDUINO_EEPROM_HEADER_CRC_BITS == 8
+    using BlockCRCType = uint8_t;
+    using BlockCRC = ArduinoEEPROMCrc8;
+#else
+    using BlockCRCType = CRCType;
+    using BlockCRC = CRC;
+#endif
+    using BlockAccess = ArduinoEEPROMBlockAccess<EEPROMClass>;
 
     enum class DataTypeEnum : uint8_t {
         STATIC_DATA = 0x01,
         WEAR_LEVEL_DATA = 0x02,
-        ALL = STATIC_DATA|WEAR_LEVEL_DATA,
+        COUNTER = 0x04,
+        RECORDS = 0x08,
+        TIME_SERIES = 0x10,
+        ALL = STATIC_DATA|WEAR_LEVEL_DATA|COUNTER|RECORDS|TIME_SERIES,
     };
 
     typedef struct __attribute__((packed)) {
-        CRCType crc;
+        BlockCRCType crc;
+#if ARDUINO_EEPROM_CYCLE_ID_BITS == 16
+        uint16_t cycleId;
+#elif ARDUINO_EEPROM_CYCLE_ID_BITS == 24
+        uint32_t cycleId: 24;
+#else
         uint32_t cycleId;
+#endif
+#if ARDUINO_EEPROM_HAVE_COMMIT_MARKER
+        uint8_t commit;
+#endif
     } DataBlockHeader_t;
 
     typedef struct __attribute__((packed)) {
@@ -185,6 +432,28 @@ public:
         uint16_t wearLevelSize;
     } Header_t;
 
+    typedef struct __attribute__((packed)) {
+        CRCType crc;
+        uint32_t cycleId;
+        EEPROMSizeType offset;
+    } Checkpoint_t;
+
+    typedef struct __attribute__((packed)) {
+        CRCType crc;
+        uint32_t cycleId;
+    } Epoch_t;
+
+    typedef struct __attribute__((packed)) {
+        CRCType crc;
+        uint32_t value;                         // value of the counter when the log was empty
+    } CounterCheckpoint_t;
+
+    // follows the header of each record
+    typedef struct __attribute__((packed)) {
+        uint8_t key;
+        uint8_t length;
+    } RecordInfo_t;
+
     typedef struct {
         struct {
             uint8_t valid;
@@ -201,6 +470,38 @@ public:
         } wearLevelData;
     } BasicInfo_t;
 
+    typedef struct {
+        EEPROMSizeType offset;
+        uint32_t cycleId;
+    } WearLevelBlock_t;
+
+    typedef struct {
+        EEPROMSizeType cursor;                  // next block, 0 is the static data and 1 the first block of the wear leveling area
+        uint8_t staticDataRepaired;             // bitset of static data copies that have been rewritten
+        uint8_t staticDataErrors;               // bitset of static data copies that could not be repaired
+        EEPROMSizeType wearLevelErrors;         // number of blocks in the wear leveling area with invalid data
+        EEPROMSizeType lastErrorOffset;         // offset of the last bad block or INVALID_OFFSET
+        uint32_t passes;                        // number of completed passes
+    } ScrubState_t;
+
+    typedef struct {
+        uint32_t cycleId;                       // cycle id of the record read by the last call of readHistory()
+        uint32_t nextCycleId;                   // cycle id of the next block
+        uint32_t oldestCycleId;                 // the iteration stops at records older than this cycle id
+        EEPROMSizeType index;                   // index of the next block
+        EEPROMSizeType remaining;               // number of blocks that have not been visited
+        BlockCRCType crc;                       // CRC of the data of the last record to skip its copies
+        uint8_t copies;                         // number of blocks read since the last record
+    } HistoryIterator_t;
+
+    typedef struct {
+        uint32_t sequence;                      // position of the sample read by the last call of readSample()
+        uint32_t cycleId;                       // cycle id of the current page
+        EEPROMSizeType page;                    // index of the current page
+        EEPROMSizeType remaining;               // number of pages that have not been visited
+        uint16_t sample;                        // index of the next sample in the current page
+    } TimeSeriesIterator_t;
+
     template <bool _Test, class _Ty1, class _Ty2>
     struct conditional {
         using type = _Ty1;
@@ -210,15 +511,21 @@ public:
         using type = _Ty2;
     };
 
-    using DataBlockSizeType = typename conditional<((ARDUINO_EEPROM_STATIC_DATA_SIZE > 255) || ARDUINO_EEPROM_WEAR_LEVEL_DATA_SIZE > 255), uint16_t, uint8_t>::type;
+    using DataBlockSizeType = typename conditional<((ARDUINO_EEPROM_STATIC_DATA_SIZE > 0xffff) || ARDUINO_EEPROM_WEAR_LEVEL_DATA_SIZE + ARDUINO_EEPROM_HAVE_DELTA > 0xffff), uint32_t,
+        typename conditional<((ARDUINO_EEPROM_STATIC_DATA_SIZE > 255) || ARDUINO_EEPROM_WEAR_LEVEL_DATA_SIZE + ARDUINO_EEPROM_HAVE_DELTA > 255), uint16_t, uint8_t>::type>::type;
 
     static constexpr EEPROMSizeType pageSize = ARDUINO_EEPROM_PAGE_SIZE;
+    static constexpr DataBlockSizeType burstSize = ARDUINO_EEPROM_BURST_SIZE;
 
     static constexpr EEPROMSizeType startOffset = ARDUINO_EEPROM_ALIGN_ADDR(ARDUINO_EEPROM_START_OFFSET);
     static constexpr EEPROMSizeType eepromLength = (ARDUINO_EEPROM_LENGTH / ARDUINO_EEPROM_PAGE_SIZE) * ARDUINO_EEPROM_PAGE_SIZE;
     static constexpr DataBlockSizeType staticDataTypeSize = ARDUINO_EEPROM_STATIC_DATA_SIZE;
     static constexpr DataBlockSizeType wearLevelDataTypeSize = ARDUINO_EEPROM_WEAR_LEVEL_DATA_SIZE;
     static constexpr DataBlockSizeType dataBlockHeaderSize = sizeof(DataBlockHeader_t);
+    // with ARDUINO_EEPROM_HAVE_DELTA, the payload starts with the number of patches since the snapshot
+    static constexpr DataBlockSizeType wearLevelPayloadSize = wearLevelDataTypeSize + ARDUINO_EEPROM_HAVE_DELTA;
+    static constexpr DataBlockSizeType deltaBitmapSize = (wearLevelDataTypeSize + 7) / 8;
+    static constexpr uint8_t deltaSnapshotInterval = ARDUINO_EEPROM_DELTA_SNAPSHOT_INTERVAL;
 
     static constexpr uint8_t staticDataCopies = ARDUINO_EEPROM_STATIC_DATA_NUM_COPIES;
     static constexpr uint8_t wearLevelDataCopies = ARDUINO_EEPROM_WEAR_LEVEL_DATA_NUM_COPIES;
@@ -230,19 +537,58 @@ public:
 #else
     static constexpr EEPROMSizeType headerOffset = ARDUINO_EEPROM_ALIGN_ADDR(startOffset);
     static constexpr uint8_t headerNumBlocks = 0;
-    static constexpr EEPROMSizeType headerLength = 0;
+    // the checkpoint and the epoch use two slots each, every slot starts at a new page
+    static constexpr uint8_t checkpointSlots = ARDUINO_EEPROM_HAVE_CHECKPOINT ? 2 : 0;
+    static constexpr EEPROMSizeType checkpointOffset = headerOffset;
+    static constexpr EEPROMSizeType checkpointLength = ARDUINO_EEPROM_ALIGN_LEN(sizeof(Checkpoint_t)) * checkpointSlots;
+    static constexpr uint8_t epochSlots = ARDUINO_EEPROM_HAVE_EPOCH ? 2 : 0;
+    static constexpr EEPROMSizeType epochOffset = checkpointOffset + checkpointLength;
+    static constexpr EEPROMSizeType epochLength = ARDUINO_EEPROM_ALIGN_LEN(sizeof(Epoch_t)) * epochSlots;
+    // the number of blocks in the wear leveling area depends on the header length, the bitmap has space for
+    // the max. number of blocks that fit into the EEPROM
+    static constexpr EEPROMSizeType badBlocksSize = ((eepromLength / ARDUINO_EEPROM_ALIGN_LEN(wearLevelPayloadSize + dataBlockHeaderSize)) + 7) / 8;
+    static constexpr uint8_t badBlocksCopies = ARDUINO_EEPROM_HAVE_BAD_BLOCKS ? 2 : 0;
+    static constexpr EEPROMSizeType badBlocksOffset = epochOffset + epochLength;
+    static constexpr EEPROMSizeType badBlocksLength = ARDUINO_EEPROM_ALIGN_LEN(sizeof(CRCType) + badBlocksSize) * badBlocksCopies;
+    static constexpr EEPROMSizeType headerLength = checkpointLength + epochLength + badBlocksLength;
 #endif
 
     static constexpr EEPROMSizeType staticDataOffset = ARDUINO_EEPROM_ALIGN_ADDR(headerOffset + headerLength);
     static constexpr EEPROMSizeType staticDataBlockSize = staticDataTypeSize + dataBlockHeaderSize;
     static constexpr EEPROMSizeType staticDataLength = ARDUINO_EEPROM_ALIGN_LEN(staticDataBlockSize) * staticDataCopies;
 
-    static constexpr EEPROMSizeType wearLevelDataOffset = ARDUINO_EEPROM_ALIGN_ADDR(staticDataOffset + staticDataLength);
+    // two checkpoint slots followed by the log
+    static constexpr EEPROMSizeType counterOffset = ARDUINO_EEPROM_ALIGN_ADDR(staticDataOffset + staticDataLength);
+    static constexpr uint8_t counterSlots = ARDUINO_EEPROM_HAVE_COUNTER ? 2 : 0;
+    static constexpr EEPROMSizeType counterLogOffset = counterOffset + ARDUINO_EEPROM_ALIGN_LEN(sizeof(CounterCheckpoint_t)) * counterSlots;
+    static constexpr DataBlockSizeType counterLogSize = ARDUINO_EEPROM_HAVE_COUNTER ? ARDUINO_EEPROM_COUNTER_LOG_SIZE : 0;
+    static constexpr EEPROMSizeType counterLength = (counterLogOffset - counterOffset) + ARDUINO_EEPROM_ALIGN_LEN(counterLogSize);
+
+    // segments of the record store, records do not cross the segment boundaries
+    static constexpr EEPROMSizeType recordStoreOffset = ARDUINO_EEPROM_ALIGN_ADDR(counterOffset + counterLength);
+    static constexpr uint8_t recordMaxKeys = ARDUINO_EEPROM_RECORD_MAX_KEYS;
+    static constexpr uint8_t recordMaxSize = ARDUINO_EEPROM_RECORD_MAX_SIZE;
+    static constexpr DataBlockSizeType recordHeaderSize = sizeof(DataBlockHeader_t) + sizeof(RecordInfo_t);
+    static constexpr EEPROMSizeType recordSegmentSize = ARDUINO_EEPROM_ALIGN_LEN(ARDUINO_EEPROM_RECORD_SEGMENT_SIZE);
+    static constexpr EEPROMSizeType recordNumSegments = ARDUINO_EEPROM_HAVE_RECORD_STORE ? (ARDUINO_EEPROM_RECORD_STORE_SIZE / recordSegmentSize) : 0;
+    static constexpr EEPROMSizeType recordStoreLength = recordNumSegments * recordSegmentSize;
+
+    // pages of the time series with header and samples. each sample is followed by its marker
+    static constexpr EEPROMSizeType timeSeriesOffset = ARDUINO_EEPROM_ALIGN_ADDR(recordStoreOffset + recordStoreLength);
+    static constexpr DataBlockSizeType timeSeriesSampleSize = ARDUINO_EEPROM_TIME_SERIES_SAMPLE_SIZE;
+    static constexpr EEPROMSizeType timeSeriesPageSize = ARDUINO_EEPROM_ALIGN_LEN(ARDUINO_EEPROM_TIME_SERIES_PAGE_SIZE);
+    static constexpr EEPROMSizeType timeSeriesSlotSize = timeSeriesSampleSize + 1;
+    static constexpr uint16_t timeSeriesSamplesPerPage = (timeSeriesPageSize - sizeof(DataBlockHeader_t)) / timeSeriesSlotSize;
+    static constexpr EEPROMSizeType timeSeriesNumPages = ARDUINO_EEPROM_HAVE_TIME_SERIES ? (ARDUINO_EEPROM_TIME_SERIES_SIZE / timeSeriesPageSize) : 0;
+    static constexpr EEPROMSizeType timeSeriesLength = timeSeriesNumPages * timeSeriesPageSize;
+
+    static constexpr EEPROMSizeType wearLevelDataOffset = ARDUINO_EEPROM_ALIGN_ADDR(timeSeriesOffset + timeSeriesLength);
     static constexpr EEPROMSizeType wearLevelDataMaxLength = eepromLength - (wearLevelDataOffset - startOffset);
-    static constexpr EEPROMSizeType wearLevelBlockSize = (wearLevelDataTypeSize + dataBlockHeaderSize);
+    static constexpr EEPROMSizeType wearLevelBlockSize = (wearLevelPayloadSize + dataBlockHeaderSize);
 
     static constexpr int32_t _wearLevelNumCycles = wearLevelDataMaxLength / (ARDUINO_EEPROM_ALIGN_LEN(wearLevelBlockSize) * wearLevelDataCopies);
-    using WearLevelCyclesType = typename conditional<(_wearLevelNumCycles > 255), uint16_t, uint8_t>::type;
+    using WearLevelCyclesType = typename conditional<(_wearLevelNumCycles > 0xffff), uint32_t,
+        typename conditional<(_wearLevelNumCycles > 255), uint16_t, uint8_t>::type>::type;
     static constexpr WearLevelCyclesType wearLevelNumCycles = (WearLevelCyclesType)_wearLevelNumCycles;
     // NOTE: wearLevelNumBlocks is NOT wearLevelNumCycles * wearLevelDataCopies
     static constexpr EEPROMSizeType wearLevelNumBlocks = wearLevelDataMaxLength / ARDUINO_EEPROM_ALIGN_LEN(wearLevelBlockSize);
@@ -252,8 +598,32 @@ public:
 
     static constexpr EEPROMSizeType INVALID_OFFSET = ~0;
 
+    // 0 is used for empty and all bits set for invalid blocks. with less than 32 bit, the cycle ids wrap around
+    // from cycleIdMax to 1
+#if ARDUINO_EEPROM_CYCLE_ID_BITS == 32
+    static constexpr uint32_t cycleIdMax = 0xfffffffeUL;
+#else
+    static constexpr uint32_t cycleIdMax = (1UL << ARDUINO_EEPROM_CYCLE_ID_BITS) - 2;
+#endif
+
     static_assert(_wearLevelNumCycles > ARDUINO_EEPROM_WEAR_LEVEL_DATA_NUM_COPIES, "Data does not fit into EEPROM");
 
+    static_assert(sizeof(DataBlockHeader_t) == sizeof(BlockCRCType) + (ARDUINO_EEPROM_CYCLE_ID_BITS / 8) + ARDUINO_EEPROM_HAVE_COMMIT_MARKER, "Header not packed");
+
+    static_assert(ARDUINO_EEPROM_CYCLE_ID_BITS == 32 || wearLevelNumBlocks < cycleIdMax / 2, "Too many blocks for ARDUINO_EEPROM_CYCLE_ID_BITS");
+
+    static_assert(!ARDUINO_EEPROM_HAVE_RECORD_STORE || recordNumSegments >= 2, "The record store requires at least 2 segments");
+
+    static_assert(!ARDUINO_EEPROM_HAVE_RECORD_STORE || recordSegmentSize >= (recordMaxKeys + 1) * (recordHeaderSize + recordMaxSize), "ARDUINO_EEPROM_RECORD_SEGMENT_SIZE cannot hold one record per key plus one additional record");
+
+    static_assert(ARDUINO_EEPROM_CYCLE_ID_BITS == 32 || recordStoreLength / recordHeaderSize < cycleIdMax / 2, "Too many records for ARDUINO_EEPROM_CYCLE_ID_BITS");
+
+    static_assert(!ARDUINO_EEPROM_HAVE_TIME_SERIES || timeSeriesNumPages >= 2, "The time series requires at least 2 pages");
+
+    static_assert(!ARDUINO_EEPROM_HAVE_TIME_SERIES || timeSeriesSamplesPerPage >= 1, "ARDUINO_EEPROM_TIME_SERIES_PAGE_SIZE cannot hold a sample");
+
+    static_assert(!ARDUINO_EEPROM_HAVE_DELTA || deltaSnapshotInterval * wearLevelDataCopies < wearLevelNumBlocks, "ARDUINO_EEPROM_DELTA_SNAPSHOT_INTERVAL exceeds the wear leveling area");
+
     static_assert(startOffset + eepromLength <= ARDUINO_EEPROM_MAX_LENGTH, "EEPROM size exceeded");
 
 private:
@@ -274,15 +644,50 @@ public:
 #endif
     {
         _debugCycleCount = 0;
+        _wearLevelHeadOffset = INVALID_OFFSET;
+#if ARDUINO_EEPROM_HAVE_EPOCH
+        _epochCycleId = 0;
+#endif
+#if ARDUINO_EEPROM_HAVE_BAD_BLOCKS
+        memset(_badBlocks, 0, sizeof(_badBlocks));
+#endif
+#if ARDUINO_EEPROM_HAVE_COUNTER
+        _counterValue = 0;
+        _counterPosition = 0;
+        _counterSlot = INVALID_COUNTER_CHECKPOINT;
+#endif
+#if ARDUINO_EEPROM_HAVE_RECORD_STORE
+        for (uint8_t i = 0; i < recordMaxKeys; i++) {
+            _recordOffsets[i] = INVALID_OFFSET;
+        }
+        _recordHeadOffset = recordStoreOffset;
+        _recordHeadCycleId = 0;
+#endif
+#if ARDUINO_EEPROM_HAVE_TIME_SERIES
+        _timeSeriesPage = 0;
+        _timeSeriesCycleId = 0;
+        _timeSeriesCount = 0;
+#endif
+#if ARDUINO_EEPROM_HAVE_SCRUB
+        memset(&_scrub, 0, sizeof(_scrub));
+        _scrub.lastErrorOffset = INVALID_OFFSET;
+#endif
+#if ARDUINO_EEPROM_HAVE_ASYNC_WRITE
+        _async.pending = false;
+        _async.result = 0;
+#endif
     }
 
+    // locates the latest block in the wear leveling area and keeps its position in RAM
+    // read and write operations do not need to scan the wear leveling area afterwards
     void begin();
 
     // clear EEPROM and set all data to zero
     // CRC checks will success
     // any write operation to an uninitialized area will fail
     // any read operation will fail until data has been written once
-    void eraseAndInitialize(DataTypeEnum type) const;
+    // with ARDUINO_EEPROM_HAVE_EPOCH, the wear leveling area is formatted by writing the epoch only
+    void eraseAndInitialize(DataTypeEnum type);
 
     // return basic information
     void getBasicInfo(BasicInfo_t &info) const;
@@ -299,6 +704,11 @@ public:
     // the data area must be intialized before any write attempt succeeds
     uint8_t writeStaticData(ConstByteAccessPointer data, uint8_t copiesBitset = ~0) const;
 
+    // write to positions set in copiesBitset if any of them has been modified and return the positions as
+    // bitset that were successful. returns 0 if the data has not been modified
+    // modified is set to true if a write was required
+    uint8_t writeStaticDataIfModified(ConstByteAccessPointer data, uint8_t copiesBitset = ~0, bool *modified = nullptr) const;
+
     // returns true if data has been changed or any error occurred
     // data is compared byte by byte to avoid checksum collisions
     bool isWearLevelDataModified(ConstByteAccessPointer data) const;
@@ -308,12 +718,123 @@ public:
     // data stored data if available
     // returns 0 for failure or the number of the copy or previously stored data if maxReadCopies
     // exceeds wearLevelDataCopies
+    // maxReadCopies is limited to ARDUINO_EEPROM_WEAR_LEVEL_MAX_READ_COPIES
     uint8_t readWearLevelData(ByteAccessPointer data, uint8_t maxReadCopies = wearLevelDataCopies) const;
 
     // write data to the wear leveling area and return number of successfully written copies (up to wearLevelDataCopies)
     // the data area must be intialized before any write attempt succeeds
     uint8_t writeWearLevelData(ConstByteAccessPointer data);
 
+    // write data to the wear leveling area if it has been modified and return number of successfully written
+    // copies. returns 0 if the data has not been modified
+    // the latest block is located once and compared by CRC first and byte by byte afterwards
+    // modified is set to true if a write was required
+    uint8_t writeWearLevelDataIfModified(ConstByteAccessPointer data, bool *modified = nullptr);
+
+#if ARDUINO_EEPROM_HAVE_CHECKPOINT
+    // store the position of the latest block in the checkpoint, for example before entering deep sleep
+    // returns false if the wear leveling area is not initialized or the checkpoint cannot be written
+    bool writeCheckpoint();
+#endif
+
+#if ARDUINO_EEPROM_HAVE_BAD_BLOCKS
+    // returns the number of blocks in the wear leveling area that are marked as bad
+    EEPROMSizeType getNumBadBlocks() const;
+#endif
+
+#if ARDUINO_EEPROM_HAVE_COUNTER
+    // increment the counter by one. usually a single byte is written
+    // returns false if the EEPROM cannot be written or the counter has reached its max. value
+    bool incrementCounter();
+
+    // returns the value of the counter. the value is read by begin() and no EEPROM access is required
+    uint32_t readCounter() const;
+#endif
+
+#if ARDUINO_EEPROM_HAVE_RECORD_STORE
+    // read the latest record of key into data. up to size bytes are copied
+    // returns the length of the record or 0 if the key does not exist or the record cannot be read
+    uint8_t readRecord(uint8_t key, ByteAccessPointer data, uint8_t size) const;
+
+    // append a record with length bytes to the store. the latest records of the following segment are copied
+    // forward before the next segment is used. only the new record and copied records are written
+    // returns false if the key or length is invalid or the record cannot be written
+    bool writeRecord(uint8_t key, ConstByteAccessPointer data, uint8_t length);
+#endif
+
+#if ARDUINO_EEPROM_HAVE_TIME_SERIES
+    // append a sample with timeSeriesSampleSize bytes. the sample and its marker are written. if the current page
+    // is full, the header of the next page is written and the oldest samples are discarded
+    // returns false if the sample cannot be written
+    bool appendSample(ConstByteAccessPointer data);
+
+    // start reading the samples from the oldest to the newest one
+    // returns false if the time series is empty
+    bool beginSamples(TimeSeriesIterator_t &iterator) const;
+
+    // read the next sample into data and store its position in iterator.sequence. the position is counted from
+    // the first sample of the oldest page, 0 to timeSeriesNumPages * timeSeriesSamplesPerPage - 1, and increases
+    // with each sample. pages with an invalid header are skipped
+    // returns false if no more samples are available
+    bool readSample(TimeSeriesIterator_t &iterator, ByteAccessPointer data) const;
+
+    // returns the number of samples that can be read
+    uint32_t getNumSamples() const;
+#endif
+
+#if ARDUINO_EEPROM_HAVE_HISTORY
+    // start reading the records of the wear leveling data from newestCycleId to oldestCycleId. by default, all
+    // records from the latest one are read. newestCycleId should be a cycle id returned by readHistory()
+    // returns false if the wear leveling area is empty or newestCycleId has been overwritten
+    bool beginHistory(HistoryIterator_t &iterator, uint32_t newestCycleId = ~0, uint32_t oldestCycleId = 0) const;
+
+    // read the next older record into data and store its cycle id in iterator.cycleId. records without a valid
+    // copy are skipped and the copies of a record are returned once
+    // returns false if no more records are available
+    bool readHistory(HistoryIterator_t &iterator, ByteAccessPointer data) const;
+
+    // read the block with cycleId. the offset is calculated from the latest block and a single block is read
+    // returns false if the block has been overwritten, is marked as bad or cannot be read
+    bool readHistory(uint32_t cycleId, ByteAccessPointer data) const;
+#endif
+
+#if ARDUINO_EEPROM_HAVE_SCRUB
+    // check up to budget blocks and continue with the next call. the static data counts as one block per copy
+    // and is always checked completely. the results in getScrubState() are reset when a new pass starts
+    // returns true if the pass has been completed
+    // must not be called while an asynchronous write operation is pending
+    bool scrub(EEPROMSizeType budget);
+
+    // returns the position and the results of the current or last completed pass
+    const ScrubState_t &getScrubState() const;
+#endif
+
+#if ARDUINO_EEPROM_HAVE_ASYNC_WRITE
+    // copy data into the buffer and start writing it to the positions set in copiesBitset
+    // the write operation is performed by poll()
+    // returns false if another write operation is pending or the cycle id cannot be determined
+    bool writeStaticDataAsync(ConstByteAccessPointer data, uint8_t copiesBitset = ~0);
+
+    // copy data into the buffer and start writing it to the wear leveling area
+    // the write operation is performed by poll()
+    // returns false if another write operation is pending or the wear leveling area is not initialized
+    bool writeWearLevelDataAsync(ConstByteAccessPointer data);
+
+    // continue a pending write operation. if the EEPROM is ready, the next byte that is different is written
+    // the payload of each block is written first and the header last. blocks are validated after writing and
+    // retried ARDUINO_EEPROM_WRITE_ERROR_RETRIES times
+    // returns true if no write operation is pending
+    // other write methods must not be called while a write operation is pending
+    bool poll();
+
+    // wait until the pending write operation has been completed
+    void flushAsync();
+
+    // returns the result of the last write operation. the bitset of copies for static data or the number
+    // of copies for the wear leveling data
+    uint8_t getAsyncResult() const;
+#endif
+
 #if ARDUINO_EEPROM_HAVE_DUMP
     // debug output
     void dumpOffsets(Print &output) const;
@@ -322,8 +843,57 @@ public:
 #endif
 
 private:
+    // benchmark/cpu.cpp measures the private methods
+    friend class ArduinoEEPROMBenchmark;
+
+#if ARDUINO_EEPROM_HAVE_ASYNC_WRITE
+    // prepare the next block for writing or end the pending write operation
+    void _nextAsyncBlock();
+#endif
+
+    // write data to the blocks following the block at offset with cycleId
+    // with ARDUINO_EEPROM_HAVE_BAD_BLOCKS, bad blocks are skipped and blocks that cannot be written are marked
+    // as bad. the cycle id is increased for each block to keep the cycle ids in sync with the position
+    uint8_t _writeWearLevelData(EEPROMSizeType offset, uint32_t cycleId, ConstByteAccessPointer data);
+
+    // compare data with the latest data of the wear leveling area. the block at offset is compared directly or
+    // with ARDUINO_EEPROM_HAVE_DELTA, the latest data is read from the snapshot and the patches
+    // returns 0 if the data has not been modified
+    uint8_t _compareWearLevelData(EEPROMSizeType offset, ConstByteAccessPointer data) const;
+
+#if ARDUINO_EEPROM_HAVE_HISTORY
+    // read the data of the block at offset with cycleId into data. validates the block and applies patches
+    // returns 1 if the data has been read, 0 if the block cannot be read and -1 if the block is empty or
+    // belongs to a previous cycle
+    int8_t _readHistoryBlock(EEPROMSizeType offset, uint32_t cycleId, uint8_t *data) const;
+#endif
+
+#if ARDUINO_EEPROM_HAVE_DELTA
+    // read the latest snapshot and apply the following patches. the blocks are collected walking backwards from
+    // the latest block, up to maxReadCopies blocks that cannot be read are skipped. the number of patches is
+    // stored in depth. each patch contains the CRC of the data it has been created from
+    // if offset is not INVALID_OFFSET, the walk starts at the block at offset with cycleId instead of the latest block
+    // returns 0 for failure or the number of skipped blocks plus 1
+    uint8_t _readWearLevelDelta(uint8_t *data, uint8_t maxReadCopies, uint8_t &depth, EEPROMSizeType offset = INVALID_OFFSET, uint32_t cycleId = 0) const;
+
+    // store data as patch against the latest data in block or as snapshot if the snapshot interval has been
+    // reached, the latest data cannot be read or the patch is not smaller
+    // returns the number of bytes that need to be written, the bytes following it are not modified
+    DataBlockSizeType _encodeWearLevelDelta(ConstByteAccessPointer data, uint8_t *block) const;
+#endif
+
     void _eraseAndInitialize(EEPROMSizeType offset, DataBlockSizeType size, EEPROMSizeType numBlocks) const;
 
+#if ARDUINO_EEPROM_HAVE_SCRUB
+    // rewrite outdated and invalid copies of the static data from a valid copy with the highest cycle id
+    // returns the number of copies that have been checked or written
+    uint8_t _scrubStaticData();
+
+    // copy the block at src to dst and validate it. the payload is copied first and the header last
+    // on failure it repeats this process ARDUINO_EEPROM_WRITE_ERROR_RETRIES times before it returns false
+    bool _copyDataBlock(EEPROMSizeType dst, EEPROMSizeType src, DataBlockSizeType size) const;
+#endif
+
     // returns the maximum cycle id, including 0 for initialized areas without any written data
     // copiesBitset as input sets which copies to check, use ~0 for all
     // copiesBitset as output indicates which copies match the maximum cycle id and can be used to read
@@ -346,8 +916,257 @@ private:
     // on failure it returns INVALID_OFFSET
     EEPROMSizeType _getWearLevelOffset(uint32_t &startCycleId, uint32_t maxCycleId = ~0UL) const;
 
+    // collect up to maxCount blocks with the highest cycle ids that are greater than 0 and less than maxCycleId
+    // in a single scan. only the headers are read, the blocks are sorted by cycle id in descending order
+    // returns the number of blocks stored in blocks[]
+    uint8_t _getWearLevelOffsets(WearLevelBlock_t *blocks, uint8_t maxCount, uint32_t maxCycleId) const;
+
+    // returns true if the block at offset does not contain data. the cycle id is 0 or the block belongs to a
+    // previous epoch
+    bool _isEmptyBlock(EEPROMSizeType offset, uint32_t cycleId) const;
+
+#if ARDUINO_EEPROM_HAVE_EPOCH
+    // read the cycle ids of all blocks and store the highest one as epoch. only the epoch is written unless
+    // it exceeds ARDUINO_EEPROM_EPOCH_MAX_CYCLE_ID or cannot be written
+    void _formatWearLevelData();
+
+    // read the latest valid epoch into _epochCycleId and return its slot or INVALID_EPOCH
+    uint8_t _readEpoch();
+
+    // write the epoch to the slot that does not contain the latest one
+    bool _writeEpoch(uint32_t cycleId);
+
+    // get offset of the epoch slot
+    EEPROMSizeType _getEpochOffset(uint8_t slot) const;
+
+    static constexpr uint8_t INVALID_EPOCH = ~0;
+#endif
+
+#if ARDUINO_EEPROM_HAVE_COUNTER
+    // read the latest valid checkpoint into _counterValue, the number of markers into _counterPosition and
+    // return the slot of the checkpoint or INVALID_COUNTER_CHECKPOINT
+    uint8_t _readCounter();
+
+    // write the checkpoint to the slot that does not contain the latest one
+    bool _writeCounterCheckpoint(uint8_t slot, uint32_t value);
+
+    // fill the log with a value that does not match any marker and invalidate the checkpoints
+    void _formatCounter();
+
+    // the marker alternates with each checkpoint. all bytes of the log contain the marker of the previous
+    // checkpoint when a new one is written. an erased cell or an interrupted write operation does not match
+    // either marker
+    inline uint8_t _getCounterLogMarker(uint32_t value) const
+    {
+        return ((value / counterLogSize) & 1) ? 0xaa : 0x55;
+    }
+
+    // get offset of the checkpoint slot
+    EEPROMSizeType _getCounterCheckpointOffset(uint8_t slot) const;
+
+    static constexpr uint8_t INVALID_COUNTER_CHECKPOINT = ~0;
+#endif
+
+#if ARDUINO_EEPROM_HAVE_TIME_SERIES
+    // find the latest page with a valid header and count its valid samples
+    void _readTimeSeries();
+
+    // clear the headers of all pages
+    void _formatTimeSeries();
+
+    // clear markers of the page that match the marker of cycleId and write its header. the header of the page is
+    // cleared before any marker is modified
+    bool _beginTimeSeriesPage(EEPROMSizeType page, uint32_t cycleId);
+
+    // returns true if the header of the page is valid and contains cycleId
+    bool _isTimeSeriesPage(EEPROMSizeType page, uint32_t cycleId) const;
+
+    // returns the number of valid samples of the page with cycleId. the samples are written in sequence and
+    // counting stops at the first invalid sample
+    uint16_t _getTimeSeriesCount(EEPROMSizeType page, uint32_t cycleId) const;
+
+    // returns true if the marker of the sample is valid for cycleId
+    bool _isTimeSeriesSample(EEPROMSizeType page, uint16_t sample, uint32_t cycleId) const;
+
+    inline EEPROMSizeType _getTimeSeriesPageOffset(EEPROMSizeType page) const
+    {
+        return timeSeriesOffset + (page * timeSeriesPageSize);
+    }
+
+    inline EEPROMSizeType _getTimeSeriesSampleOffset(EEPROMSizeType page, uint16_t sample) const
+    {
+        return _getTimeSeriesPageOffset(page) + sizeof(DataBlockHeader_t) + (sample * timeSeriesSlotSize);
+    }
+
+    // the marker alternates with each cycle of the pages. an erased cell or an interrupted write operation does
+    // not match either marker
+    inline uint8_t _getTimeSeriesMarker(uint32_t cycleId) const
+    {
+        return (((cycleId - 1) / timeSeriesNumPages) & 1) ? 0xaa : 0x55;
+    }
+#endif
+
+#if ARDUINO_EEPROM_HAVE_RECORD_STORE
+    // scan all segments and store the offset of the latest record of each key and the end of the latest record
+    // the records of a segment are read until a record is invalid or its cycle id does not follow the previous one
+    void _readRecords();
+
+    // clear the record store
+    void _formatRecords();
+
+    // return the offset for a record with length bytes. if the record does not fit into the current segment, the
+    // next segment is used. the latest records of the segment following the current segment are copied forward first
+    // returns INVALID_OFFSET if a record cannot be copied
+    EEPROMSizeType _allocateRecord(uint8_t length);
+
+    // write a record with the next cycle id at offset and update the index
+    bool _writeRecord(EEPROMSizeType offset, uint8_t key, ConstByteAccessPointer data, uint8_t length);
+
+    // read the header of the record at offset and validate the CRC of the record
+    // returns false if the record is empty, invalid or does not fit into the segment
+    bool _readRecordHeader(EEPROMSizeType offset, DataBlockHeader_t &header, RecordInfo_t &info) const;
+
+    // returns the index of the segment containing offset
+    inline EEPROMSizeType _getRecordSegment(EEPROMSizeType offset) const
+    {
+        return (offset - recordStoreOffset) / recordSegmentSize;
+    }
+#endif
+
+    // returns the offset of the latest block in the wear leveling area and its cycle id
+    // uses the cached position if available or scans the wear leveling area
+    // on failure it returns INVALID_OFFSET
+    EEPROMSizeType _getWearLevelHeadOffset(uint32_t &cycleId) const;
+
+    // binary search for the latest block in the wear leveling area. blocks are written in sequence, the
+    // cycle ids from the first block up to the latest block are consecutive and the following blocks
+    // contain older data. reads O(log wearLevelNumBlocks) headers and validates the CRC of the result
+    // returns INVALID_OFFSET if the headers are not consistent, for example due to corrupted blocks
+    EEPROMSizeType _findWearLevelHeadOffset(uint32_t &cycleId) const;
+
+    // verify the block at index as latest block. the following blocks must contain data from the previous
+    // cycle or must be empty and the CRC of the block must match
+    // returns the offset of the block or INVALID_OFFSET
+    EEPROMSizeType _validateWearLevelHeadOffset(EEPROMSizeType index, uint32_t cycleId) const;
+
+#if ARDUINO_EEPROM_HAVE_CHECKPOINT
+    // locate the latest block starting at the position stored in the checkpoint. the blocks following it are
+    // checked at exponentially growing distances and the last step is searched binary. reads O(log n) headers
+    // for n blocks written after the checkpoint
+    // returns INVALID_OFFSET if there is no valid checkpoint or it does not match the wear leveling area
+    EEPROMSizeType _findWearLevelHeadOffsetFromCheckpoint(uint32_t &cycleId) const;
+
+    // read the latest valid checkpoint and return its slot or INVALID_CHECKPOINT
+    uint8_t _readCheckpoint(Checkpoint_t &checkpoint) const;
+
+    // write the checkpoint to the slot that does not contain the latest one. the previous checkpoint remains
+    // valid if the write operation gets interrupted
+    bool _writeCheckpoint(EEPROMSizeType offset, uint32_t cycleId) const;
+
+    // create CRC of the checkpoint
+    uint16_t _checkpointCrc(const Checkpoint_t &checkpoint) const;
+
+    // get offset of the checkpoint slot
+    EEPROMSizeType _getCheckpointOffset(uint8_t slot) const;
+
+    static constexpr uint8_t INVALID_CHECKPOINT = ~0;
+#endif
+
+    // get offset for block index in the wear leveling area
+    EEPROMSizeType _getWearLevelBlockOffset(EEPROMSizeType index) const;
+
+    // get block index for offset in the wear leveling area
+    EEPROMSizeType _getWearLevelBlockIndex(EEPROMSizeType offset) const;
+
+    // check if the block at distance from the block at index first contains the cycle id of the first block
+    // plus distance. bad blocks are skipped and distance is set to the block that has been checked
+    // returns false if there is no block before end
+    bool _isWearLevelSequence(EEPROMSizeType first, uint32_t cycleId, EEPROMSizeType &distance, EEPROMSizeType end) const;
+
+    // add distance to the cycle id. with less than 32 bit, 0 and all bits set are skipped
+    inline uint32_t _addCycleId(uint32_t cycleId, int32_t distance) const
+    {
+#if ARDUINO_EEPROM_CYCLE_ID_BITS == 32
+        return cycleId + distance;
+#else
+        distance %= (int32_t)cycleIdMax;
+        if (distance < 0) {
+            distance += cycleIdMax;
+        }
+        return (((cycleId + cycleIdMax - 1) % cycleIdMax + distance) % cycleIdMax) + 1;
+#endif
+    }
+
+    // returns the number of cycle ids from cycleId to the newer cycle id
+    inline uint32_t _getCycleIdDistance(uint32_t newer, uint32_t cycleId) const
+    {
+#if ARDUINO_EEPROM_CYCLE_ID_BITS == 32
+        return newer - cycleId;
+#else
+        return (newer + cycleIdMax - (cycleId % cycleIdMax)) % cycleIdMax;
+#endif
+    }
+
+    // returns true if cycleId is newer than other. 0 is older and ~0 is newer than any cycle id. with less than
+    // 32 bit, a cycle id is newer if it is less than half of the cycle ids ahead
+    inline bool _isNewerCycleId(uint32_t cycleId, uint32_t other) const
+    {
+#if ARDUINO_EEPROM_CYCLE_ID_BITS == 32
+        return cycleId > other;
+#else
+        if (cycleId == other || cycleId == 0 || other == (uint32_t)~0) {
+            return false;
+        }
+        if (other == 0 || cycleId == (uint32_t)~0) {
+            return true;
+        }
+        return _getCycleIdDistance(cycleId, other) < cycleIdMax / 2;
+#endif
+    }
+
+    // returns true if the block at index is marked as bad
+    inline bool _isBadBlock(EEPROMSizeType index) const
+    {
+#if ARDUINO_EEPROM_HAVE_BAD_BLOCKS
+        return _badBlocks[index / 8] & _BV(index % 8);
+#else
+        (void)index;
+        return false;
+#endif
+    }
+
+#if ARDUINO_EEPROM_HAVE_BAD_BLOCKS
+    // mark the block at offset as bad and store the bitmap
+    void _markBadBlock(EEPROMSizeType offset);
+
+    // read the bitmap. bad blocks of both copies with a valid CRC are merged
+    void _readBadBlocks();
+
+    // write the bitmap to both copies and validate them
+    bool _writeBadBlocks();
+
+    // returns the CRC of the bitmap at offset and merges it if merge is true
+    CRCType _readBadBlocks(EEPROMSizeType offset, bool merge);
+
+    // get offset of the copy of the bitmap
+    EEPROMSizeType _getBadBlocksOffset(uint8_t copy) const;
+#endif
+
+    // read cycle id from header at offset
+    // returns ~0 if the commit marker does not match
+    // with ARDUINO_EEPROM_HAVE_EPOCH, it returns 0 for empty blocks and blocks without commit marker
+    uint32_t _readCycleId(EEPROMSizeType offset) const;
+
+    // set cycle id and commit marker
+    void _setDataBlockHeaderCycleId(DataBlockHeader_t &header, uint32_t cycleId) const;
+
+#if ARDUINO_EEPROM_HAVE_COMMIT_MARKER
+    // returns the commit marker for cycleId
+    uint8_t _getCommitMarker(uint32_t cycleId) const;
+#endif
+
     // create CRC of header
-    uint16_t _dataBlockHeaderCrc(const DataBlockHeader_t &header) const;
+    BlockCRCType _dataBlockHeaderCrc(const DataBlockHeader_t &header) const;
 
     // read data from offset
     // return false if the cycle id is 0 or the data is invalid
@@ -355,8 +1174,10 @@ private:
     bool _readDataBlock(EEPROMSizeType offset, ByteAccessPointer data, DataBlockSizeType size, DataBlockHeader_t &header) const;
 
     // write data to offset and re-read it to validate data integrity
+    // the payload is written first and the header last. if the write operation gets interrupted, the
+    // block has either the previous cycle id or a CRC mismatch. see _eepromWriteDataBlock() for block access
     // on failure it repeats this process ARDUINO_EEPROM_WRITE_ERROR_RETRIES times before it returns false
-    bool _writeDataBlock(EEPROMSizeType offset, uint32_t cycleId, ConstByteAccessPointer data, DataBlockSizeType size) const;
+    bool _writeDataBlock(EEPROMSizeType offset, uint32_t cycleId, ConstByteAccessPointer data, DataBlockSizeType size, uint8_t retries = ARDUINO_EEPROM_WRITE_ERROR_RETRIES) const;
 
     // read data from eeprom
     EEPROMSizeType _eepromRead(EEPROMSizeType offset, ByteAccessPointer data, DataBlockSizeType size) const;
@@ -368,9 +1189,27 @@ private:
     // the update() method of the EEPROM class is used
     EEPROMSizeType _eepromWrite(EEPROMSizeType offset, ConstByteAccessPointer data, DataBlockSizeType size) const;
 
+    // write header and payload of a block if the EEPROM class supports writing blocks
+    // the beginning of the payload that shares a burst with the header is written together with the header
+    // in a single transaction after the remaining payload
+    void _eepromWriteDataBlock(EEPROMSizeType offset, const DataBlockHeader_t &header, ConstByteAccessPointer data, DataBlockSizeType size) const;
+
+    // returns the length of the next burst for write operations
+    DataBlockSizeType _getBurstLength(EEPROMSizeType offset, DataBlockSizeType size) const;
+
+    // write a single burst if the EEPROM class supports writing blocks
+    // the data is compared first and only the range from the first to the last modified byte is written
+    EEPROMSizeType _eepromUpdateBlock(EEPROMSizeType offset, const uint8_t *data, DataBlockSizeType len) const;
+
 #if ARDUINO_EEPROM_HAVE_BYTEARRAY_INTERFACE
-    // crc_update using ByteAccessInterface
-    uint16_t crc16_update(uint16_t crc, ConstByteAccessPointer data, size_t len) const;
+    // update the CRC of a data block using ByteAccessInterface
+    BlockCRCType _dataBlockCrcUpdate(BlockCRCType crc, ConstByteAccessPointer data, size_t len) const;
+#else
+    // update the CRC of a data block using the selected CRC engine
+    inline BlockCRCType _dataBlockCrcUpdate(BlockCRCType crc, ConstByteAccessPointer data, size_t len) const
+    {
+        return BlockCRC::update(crc, data, len);
+    }
 #endif
 
     // returns if a data block is valid
@@ -387,10 +1226,75 @@ public:
         NONE,
         STATIC_DATA,
         WEAR_LEVEL_DATA,
+        CHECKPOINT,
+        EPOCH,
+        BAD_BLOCKS,
+        COUNTER,
+        RECORDS,
+        TIME_SERIES,
     };
     static ASSERT_DATA_TYPE _assertDataType;
 #endif
     uint32_t _debugCycleCount;
+
+    // position of the latest block in the wear leveling area, INVALID_OFFSET if unknown
+    EEPROMSizeType _wearLevelHeadOffset;
+    uint32_t _wearLevelHeadCycleId;
+
+    // blocks with a cycle id less or equal are empty
+#if ARDUINO_EEPROM_HAVE_EPOCH
+    uint32_t _epochCycleId;
+#else
+    static constexpr uint32_t _epochCycleId = 0;
+#endif
+
+#if ARDUINO_EEPROM_HAVE_BAD_BLOCKS
+    uint8_t _badBlocks[badBlocksSize];
+#endif
+
+#if ARDUINO_EEPROM_HAVE_COUNTER
+    uint32_t _counterValue;                     // value of the latest checkpoint
+    uint16_t _counterPosition;                  // number of markers in the log
+    uint8_t _counterSlot;                       // slot of the latest checkpoint
+#endif
+
+#if ARDUINO_EEPROM_HAVE_RECORD_STORE
+    EEPROMSizeType _recordOffsets[recordMaxKeys];   // latest record of each key or INVALID_OFFSET
+    EEPROMSizeType _recordHeadOffset;               // end of the latest record
+    uint32_t _recordHeadCycleId;                    // cycle id of the latest record, 0 if the store is empty
+#endif
+
+#if ARDUINO_EEPROM_HAVE_TIME_SERIES
+    EEPROMSizeType _timeSeriesPage;                 // latest page
+    uint32_t _timeSeriesCycleId;                    // cycle id of the latest page, 0 if the time series is empty
+    uint16_t _timeSeriesCount;                      // number of samples in the latest page
+#endif
+
+#if ARDUINO_EEPROM_HAVE_SCRUB
+    ScrubState_t _scrub;
+#endif
+
+#if ARDUINO_EEPROM_HAVE_ASYNC_WRITE
+    struct {
+        uint8_t data[max(staticDataTypeSize, wearLevelPayloadSize)];
+        DataBlockHeader_t header;
+        EEPROMSizeType offset;          // offset of the current block
+        DataBlockSizeType size;
+#if ARDUINO_EEPROM_HAVE_DELTA
+        DataBlockSizeType length;       // length of the patch, the bytes following it are read before each block
+#endif
+        DataBlockSizeType position;     // next byte to write, the header follows the payload
+        DataTypeEnum type;
+        uint8_t copy;                   // index of the next copy
+        uint8_t copiesBitset;
+        uint8_t retries;
+        uint8_t result;
+#if ARDUINO_EEPROM_HAVE_BAD_BLOCKS
+        uint8_t failures;               // number of blocks that could not be written
+#endif
+        bool pending;
+    } _async;
+#endif
 };
 
 // convenient way for using data classes/structures
@@ -404,9 +1308,11 @@ public:
     using ArduinoEEPROMBase::isStaticDataModified;
     using ArduinoEEPROMBase::readStaticData;
     using ArduinoEEPROMBase::writeStaticData;
+    using ArduinoEEPROMBase::writeStaticDataIfModified;
     using ArduinoEEPROMBase::isWearLevelDataModified;
     using ArduinoEEPROMBase::readWearLevelData;
     using ArduinoEEPROMBase::writeWearLevelData;
+    using ArduinoEEPROMBase::writeWearLevelDataIfModified;
 
     static_assert(sizeof(StaticDataType) >= staticDataTypeSize, "sizeof(StaticDataType) < staticDataTypeSize");
     static_assert(sizeof(WearLevelDataType) >= wearLevelDataTypeSize, "sizeof(WearLevelDataType) < wearLevelDataTypeSize");
@@ -426,6 +1332,11 @@ public:
         return ArduinoEEPROMBase::writeStaticData(ConstByteAccessArray(&data), copiesBitset);
     }
 
+    inline uint8_t writeStaticDataIfModified(const StaticDataType &data, uint8_t copiesBitset = ~0, bool *modified = nullptr)
+    {
+        return ArduinoEEPROMBase::writeStaticDataIfModified(ConstByteAccessArray(&data), copiesBitset, modified);
+    }
+
     inline bool isWearLevelDataModified(const WearLevelDataType &data)
     {
         return ArduinoEEPROMBase::isWearLevelDataModified(ConstByteAccessArray(&data));
@@ -440,6 +1351,194 @@ public:
     {
         return ArduinoEEPROMBase::writeWearLevelData(ConstByteAccessArray(&data));
     }
+
+    inline uint8_t writeWearLevelDataIfModified(const WearLevelDataType &data, bool *modified = nullptr)
+    {
+        return ArduinoEEPROMBase::writeWearLevelDataIfModified(ConstByteAccessArray(&data), modified);
+    }
+
+#if ARDUINO_EEPROM_HAVE_ASYNC_WRITE
+    using ArduinoEEPROMBase::writeStaticDataAsync;
+    using ArduinoEEPROMBase::writeWearLevelDataAsync;
+
+    inline bool writeStaticDataAsync(const StaticDataType &data, uint8_t copiesBitset = ~0)
+    {
+        return ArduinoEEPROMBase::writeStaticDataAsync(ConstByteAccessArray(&data), copiesBitset);
+    }
+
+    inline bool writeWearLevelDataAsync(const WearLevelDataType &data)
+    {
+        return ArduinoEEPROMBase::writeWearLevelDataAsync(ConstByteAccessArray(&data));
+    }
+#endif
+
+#if ARDUINO_EEPROM_HAVE_TIME_SERIES
+    // the size of the sample type must match ARDUINO_EEPROM_TIME_SERIES_SAMPLE_SIZE
+    template<class SampleType>
+    inline bool appendSample(const SampleType &data)
+    {
+        static_assert(sizeof(SampleType) == timeSeriesSampleSize, "sizeof(SampleType) != ARDUINO_EEPROM_TIME_SERIES_SAMPLE_SIZE");
+        return ArduinoEEPROMBase::appendSample(ConstByteAccessArray(&data));
+    }
+
+    template<class SampleType>
+    inline bool readSample(TimeSeriesIterator_t &iterator, SampleType &data) const
+    {
+        static_assert(sizeof(SampleType) == timeSeriesSampleSize, "sizeof(SampleType) != ARDUINO_EEPROM_TIME_SERIES_SAMPLE_SIZE");
+        return ArduinoEEPROMBase::readSample(iterator, ByteAccessArray(&data));
+    }
+#endif
+
+#if ARDUINO_EEPROM_HAVE_HISTORY
+    using ArduinoEEPROMBase::readHistory;
+
+    inline bool readHistory(HistoryIterator_t &iterator, WearLevelDataType &data) const
+    {
+        return ArduinoEEPROMBase::readHistory(iterator, ByteAccessArray(&data));
+    }
+
+    inline bool readHistory(uint32_t cycleId, WearLevelDataType &data) const
+    {
+        return ArduinoEEPROMBase::readHistory(cycleId, ByteAccessArray(&data));
+    }
+#endif
+
+#if ARDUINO_EEPROM_HAVE_RECORD_STORE
+    using ArduinoEEPROMBase::readRecord;
+    using ArduinoEEPROMBase::writeRecord;
+
+    // returns true if the record exists and has the size of the type
+    template<class RecordType>
+    inline bool readRecord(uint8_t key, RecordType &data)
+    {
+        static_assert(sizeof(RecordType) <= recordMaxSize, "sizeof(RecordType) > ARDUINO_EEPROM_RECORD_MAX_SIZE");
+        return ArduinoEEPROMBase::readRecord(key, ByteAccessArray(&data), sizeof(data)) == sizeof(data);
+    }
+
+    template<class RecordType>
+    inline bool writeRecord(uint8_t key, const RecordType &data)
+    {
+        static_assert(sizeof(RecordType) <= recordMaxSize, "sizeof(RecordType) > ARDUINO_EEPROM_RECORD_MAX_SIZE");
+        return ArduinoEEPROMBase::writeRecord(key, ConstByteAccessArray(&data), sizeof(data));
+    }
+#endif
+};
+
+// write-back cache for the wear leveling data
+// writeWearLevelData() keeps the data in RAM and writes it to the EEPROM once maxUpdates updates have
+// been stored, the oldest update is older than maxAge milliseconds or flush() is called
+// loop() must be called frequently to write the data when it is getting too old
+// requires sizeof(WearLevelDataType) + 10 byte RAM
+
+template<class StaticDataType, class WearLevelDataType>
+class ArduinoEEPROMWriteBackTpl : public ArduinoEEPROMTpl<StaticDataType, WearLevelDataType>
+{
+public:
+    using Base = ArduinoEEPROMTpl<StaticDataType, WearLevelDataType>;
+    using Base::Base;
+    using Base::wearLevelDataCopies;
+    using Base::wearLevelDataTypeSize;
+
+    inline void begin()
+    {
+        Base::begin();
+        _updates = 0;
+        _dirty = false;
+    }
+
+    // set commit policy, 0 disables the limit
+    inline void setPolicy(uint16_t maxUpdates, uint32_t maxAge)
+    {
+        _maxUpdates = maxUpdates;
+        _maxAge = maxAge;
+    }
+
+    // returns the data stored in RAM or reads it from the EEPROM
+    uint8_t readWearLevelData(WearLevelDataType &data, uint8_t maxReadCopies = wearLevelDataCopies)
+    {
+        if (_dirty) {
+            memcpy(&data, &_data, wearLevelDataTypeSize);
+            return 1;
+        }
+        return Base::readWearLevelData(data, maxReadCopies);
+    }
+
+    bool isWearLevelDataModified(const WearLevelDataType &data)
+    {
+        if (_dirty) {
+            return memcmp(&data, &_data, wearLevelDataTypeSize) != 0;
+        }
+        return Base::isWearLevelDataModified(data);
+    }
+
+    // store data in RAM and write it to the EEPROM if required by the commit policy
+    // returns the number of successfully written copies or wearLevelDataCopies if the data has not been
+    // written yet
+    uint8_t writeWearLevelData(const WearLevelDataType &data)
+    {
+        if (_dirty && memcmp(&data, &_data, wearLevelDataTypeSize) == 0) {
+            return wearLevelDataCopies;
+        }
+        if (!_dirty) {
+            _time = millis();
+            _dirty = true;
+        }
+        memcpy(&_data, &data, wearLevelDataTypeSize);
+        // the counter is only used for the commit policy and does not wrap around
+        if (_updates != 0xffff) {
+            _updates++;
+        }
+        if (_maxUpdates && _updates >= _maxUpdates) {
+            return flush();
+        }
+        return loop();
+    }
+
+    // write data to the EEPROM if it is older than maxAge
+    // returns the number of successfully written copies or wearLevelDataCopies if nothing has been written
+    uint8_t loop()
+    {
+        if (_dirty && _maxAge && (millis() - _time) >= _maxAge) {
+            return flush();
+        }
+        return wearLevelDataCopies;
+    }
+
+    // write data to the EEPROM if it has been modified. if no copy could be written, the data is kept in RAM and
+    // the next call of flush() or loop() after maxAge tries again
+    // returns the number of successfully written copies or wearLevelDataCopies if nothing has been written
+    uint8_t flush()
+    {
+        if (!_dirty) {
+            return wearLevelDataCopies;
+        }
+        bool modified;
+        auto result = Base::writeWearLevelDataIfModified(_data, &modified);
+        _updates = 0;
+        if (!modified) {
+            result = wearLevelDataCopies;
+        }
+        else if (result == 0) {
+            _time = millis();
+            return result;
+        }
+        _dirty = false;
+        return result;
+    }
+
+    // returns true if the data in RAM has not been written yet
+    inline bool isDirty() const
+    {
+        return _dirty;
+    }
+
+private:
+    WearLevelDataType _data;
+    uint16_t _updates = 0;
+    bool _dirty = false;
+    uint16_t _maxUpdates = ARDUINO_EEPROM_WRITE_BACK_MAX_UPDATES;
+    uint32_t _maxAge = ARDUINO_EEPROM_WRITE_BACK_MAX_AGE;
+    uint32_t _time;
 };
 
 #if _MSC_VER
@@ -0,0 +1,84 @@
+/**
+ * Author: sascha_lammers@gmx.de
+ */
+
+#pragma once
+
+#include <Arduino.h>
+
+// detects at compile time if the EEPROM class can read and write blocks of data
+//
+// read(address, uint8_t *data, length)
+// write(address, const uint8_t *data, length)
+//
+// external EEPROMs transfer a block with a single bus transaction instead of one per byte. if a method
+// is not available, the block is transferred with the single byte read() and write()
+
+template<class _Ty>
+_Ty &ArduinoEEPROMDeclVal();
+
+template<class _EEPROMClass>
+struct ArduinoEEPROMHasBlockRead {
+    template<class _Ty>
+    static char _test(decltype((void)ArduinoEEPROMDeclVal<_Ty>().read((uint16_t)0, (uint8_t *)nullptr, (uint16_t)0), 0) *);
+    template<class _Ty>
+    static long _test(...);
+
+    static constexpr bool value = sizeof(_test<_EEPROMClass>(nullptr)) == sizeof(char);
+};
+
+template<class _EEPROMClass>
+struct ArduinoEEPROMHasBlockWrite {
+    template<class _Ty>
+    static char _test(decltype((void)ArduinoEEPROMDeclVal<_Ty>().write((uint16_t)0, (const uint8_t *)nullptr, (uint16_t)0), 0) *);
+    template<class _Ty>
+    static long _test(...);
+
+    static constexpr bool value = sizeof(_test<_EEPROMClass>(nullptr)) == sizeof(char);
+};
+
+template<class _EEPROMClass, bool _HasBlockRead = ArduinoEEPROMHasBlockRead<_EEPROMClass>::value>
+struct ArduinoEEPROMBlockRead {
+    template<class _SizeType>
+    static inline void read(_EEPROMClass &eeprom, _SizeType offset, uint8_t *data, uint16_t len)
+    {
+        while (len--) {
+            *data++ = eeprom.read(offset++);
+        }
+    }
+};
+
+template<class _EEPROMClass>
+struct ArduinoEEPROMBlockRead<_EEPROMClass, true> {
+    template<class _SizeType>
+    static inline void read(_EEPROMClass &eeprom, _SizeType offset, uint8_t *data, uint16_t len)
+    {
+        eeprom.read(offset, data, len);
+    }
+};
+
+template<class _EEPROMClass, bool _HasBlockWrite = ArduinoEEPROMHasBlockWrite<_EEPROMClass>::value>
+struct ArduinoEEPROMBlockWrite {
+    template<class _SizeType>
+    static inline void write(_EEPROMClass &eeprom, _SizeType offset, const uint8_t *data, uint16_t len)
+    {
+        while (len--) {
+            eeprom.write(offset++, *data++);
+        }
+    }
+};
+
+template<class _EEPROMClass>
+struct ArduinoEEPROMBlockWrite<_EEPROMClass, true> {
+    template<class _SizeType>
+    static inline void write(_EEPROMClass &eeprom, _SizeType offset, const uint8_t *data, uint16_t len)
+    {
+        eeprom.write(offset, data, len);
+    }
+};
+
+template<class _EEPROMClass>
+struct ArduinoEEPROMBlockAccess : ArduinoEEPROMBlockRead<_EEPROMClass>, ArduinoEEPROMBlockWrite<_EEPROMClass> {
+    static constexpr bool hasBlockRead = ArduinoEEPROMHasBlockRead<_EEPROMClass>::value;
+    static constexpr bool hasBlockWrite = ArduinoEEPROMHasBlockWrite<_EEPROMClass>::value;
+};
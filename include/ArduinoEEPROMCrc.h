@@ -0,0 +1,117 @@
+/**
+ * Author: sascha_lammers@gmx.de
+ */
+
+#pragma once
+
+#include <Arduino.h>
+#include "crc16.h"
+
+// CRC-16 engines with the polynomial 0xa001. all engines produce the same result as crc16_update() from libcrc16
+// and the EEPROM layout does not change
+
+// crc16_update() from libcrc16, bitwise. smallest code and no tables
+#define ARDUINO_EEPROM_CRC_BITWISE                          0
+// table with 256 entries stored in PROGMEM, 512 byte flash
+#define ARDUINO_EEPROM_CRC_TABLE                            1
+// slicing-by-8 with 8 tables of 256 entries, 4096 byte RAM. processes 8 byte per iteration
+// for 32 bit MCUs and the host system
+#define ARDUINO_EEPROM_CRC_SLICE_BY_8                       2
+
+// select the CRC engine used by ArduinoEEPROMBase
+#ifndef ARDUINO_EEPROM_CRC_ENGINE
+#define ARDUINO_EEPROM_CRC_ENGINE                           ARDUINO_EEPROM_CRC_BITWISE
+#endif
+#if ARDUINO_EEPROM_CRC_ENGINE > ARDUINO_EEPROM_CRC_SLICE_BY_8
+#error Invalid CRC engine
+#endif
+#if ARDUINO_EEPROM_CRC_ENGINE == ARDUINO_EEPROM_CRC_SLICE_BY_8 && defined(__AVR__)
+#error ARDUINO_EEPROM_CRC_SLICE_BY_8 requires 4096 byte RAM, use ARDUINO_EEPROM_CRC_TABLE
+#endif
+
+template<uint8_t _Engine>
+struct ArduinoEEPROMCrc16;
+
+template<>
+struct ArduinoEEPROMCrc16<ARDUINO_EEPROM_CRC_BITWISE> {
+
+    static inline uint16_t update(uint16_t crc, uint8_t data)
+    {
+        return ::crc16_update(crc, data);
+    }
+
+    static inline uint16_t update(uint16_t crc, const void *data, size_t len)
+    {
+        return ::crc16_update(crc, data, len);
+    }
+};
+
+template<>
+struct ArduinoEEPROMCrc16<ARDUINO_EEPROM_CRC_TABLE> {
+
+    static const uint16_t table[256] PROGMEM;
+
+    static inline uint16_t update(uint16_t crc, uint8_t data)
+    {
+        return (crc >> 8) ^ pgm_read_word(&table[(uint8_t)(crc ^ data)]);
+    }
+
+    static uint16_t update(uint16_t crc, const void *data, size_t len)
+    {
+        auto ptr = reinterpret_cast<const uint8_t *>(data);
+        while (len--) {
+            crc = update(crc, *ptr++);
+        }
+        return crc;
+    }
+};
+
+template<>
+struct ArduinoEEPROMCrc16<ARDUINO_EEPROM_CRC_SLICE_BY_8> {
+
+    // the tables are created during static initialization
+    static uint16_t table[8][256];
+
+    static inline uint16_t update(uint16_t crc, uint8_t data)
+    {
+        return (crc >> 8) ^ table[0][(uint8_t)(crc ^ data)];
+    }
+
+    static uint16_t update(uint16_t crc, const void *data, size_t len)
+    {
+        auto ptr = reinterpret_cast<const uint8_t *>(data);
+        while (len >= 8) {
+            crc = table[7][(uint8_t)(ptr[0] ^ crc)] ^ table[6][(uint8_t)(ptr[1] ^ (crc >> 8))] ^
+                table[5][ptr[2]] ^ table[4][ptr[3]] ^ table[3][ptr[4]] ^ table[2][ptr[5]] ^ table[1][ptr[6]] ^ table[0][ptr[7]];
+            ptr += 8;
+            len -= 8;
+        }
+        while (len--) {
+            crc = update(crc, *ptr++);
+        }
+        return crc;
+    }
+};
+
+// CRC-8 with the polynomial 0x07 for block headers with ARDUINO_EEPROM_HEADER_CRC_BITS=8, bitwise
+// same result as _crc8_ccitt_update() from avr-libc
+struct ArduinoEEPROMCrc8 {
+
+    static inline uint8_t update(uint8_t crc, uint8_t data)
+    {
+        crc ^= data;
+        for (uint8_t i = 0; i < 8; i++) {
+            crc = (crc & 0x80) ? ((crc << 1) ^ 0x07) : (crc << 1);
+        }
+        return crc;
+    }
+
+    static uint8_t update(uint8_t crc, const void *data, size_t len)
+    {
+        auto ptr = reinterpret_cast<const uint8_t *>(data);
+        while (len--) {
+            crc = update(crc, *ptr++);
+        }
+        return crc;
+    }
+};
@@ -0,0 +1,214 @@
+/**
+ * Author: sascha_lammers@gmx.de
+ */
+
+#pragma once
+
+#include <Arduino.h>
+#include <Wire.h>
+
+// adapter for external I2C EEPROMs like the 24LC256 that can be used as ARDUINO_EEPROM_CLASS
+//
+// - block read and write methods, which are detected by ArduinoEEPROMBlockAccess
+// - write operations are split at page boundaries and limited to the Wire buffer
+// - ACK polling detects the end of the write cycle instead of waiting a fixed time
+// - isReady() for non-blocking writes
+// - addresses above the address bytes are sent with the lower bits of the device address (M24M02, 24LC16)
+//
+// arduino_eeprom_config.h:
+//
+// #include <ArduinoEEPROMI2C.h>
+// extern ArduinoEEPROMI2C I2CEEPROM;
+// #define ARDUINO_EEPROM_CLASS                ArduinoEEPROMI2C
+// #define ARDUINO_EEPROM_OBJECT               I2CEEPROM
+// #define ARDUINO_EEPROM_MAX_LENGTH           32768
+// #define ARDUINO_EEPROM_IS_READY()           _eeprom.isReady()
+//
+// main.cpp:
+//
+// ArduinoEEPROMI2C I2CEEPROM(Wire, 0x50, 32768, 64);
+
+// use ACK polling. if disabled, each write operation is followed by a delay of ARDUINO_EEPROM_I2C_WRITE_CYCLE_TIME
+#ifndef ARDUINO_EEPROM_I2C_ACK_POLLING
+#define ARDUINO_EEPROM_I2C_ACK_POLLING                      1
+#endif
+
+// max. write cycle time in milliseconds. timeout for ACK polling
+#ifndef ARDUINO_EEPROM_I2C_WRITE_CYCLE_TIME
+#define ARDUINO_EEPROM_I2C_WRITE_CYCLE_TIME                 5
+#endif
+
+// adds the block read and write methods. if disabled, every byte is transferred with a separate transaction
+#ifndef ARDUINO_EEPROM_I2C_BLOCK_ACCESS
+#define ARDUINO_EEPROM_I2C_BLOCK_ACCESS                     1
+#endif
+
+// size of the Wire buffer, including the address bytes for write operations
+#ifndef ARDUINO_EEPROM_I2C_BUFFER_SIZE
+#if defined(BUFFER_LENGTH)
+#define ARDUINO_EEPROM_I2C_BUFFER_SIZE                      BUFFER_LENGTH
+#else
+#define ARDUINO_EEPROM_I2C_BUFFER_SIZE                      32
+#endif
+#endif
+
+class ArduinoEEPROMI2C {
+public:
+    ArduinoEEPROMI2C(TwoWire &wire, uint8_t address = 0x50, uint32_t length = 32768, uint16_t pageSize = 64, uint8_t addressBytes = 2) :
+        _wire(wire),
+        _length(length),
+        _pageSize(pageSize),
+        _address(address),
+        _addressBytes(addressBytes)
+    {
+    }
+
+    inline uint8_t read(uint32_t address)
+    {
+        uint8_t value = 0xff;
+        _read(address, &value, 1);
+        return value;
+    }
+
+    inline void write(uint32_t address, uint8_t value)
+    {
+        _write(address, &value, 1);
+    }
+
+    inline void update(uint32_t address, uint8_t value)
+    {
+        if (read(address) != value) {
+            write(address, value);
+        }
+    }
+
+    inline uint32_t length() const
+    {
+        return _length;
+    }
+
+#if ARDUINO_EEPROM_I2C_BLOCK_ACCESS
+    // read a block of data with as few transactions as possible
+    // returns false if the EEPROM did not respond
+    inline bool read(uint32_t address, uint8_t *data, uint16_t length)
+    {
+        return _read(address, data, length);
+    }
+
+    // write a block of data. a write operation is split at page boundaries
+    // returns false if the EEPROM did not respond
+    inline bool write(uint32_t address, const uint8_t *data, uint16_t length)
+    {
+        return _write(address, data, length);
+    }
+#endif
+
+    // returns true if the write cycle has been completed
+    bool isReady()
+    {
+#if ARDUINO_EEPROM_I2C_ACK_POLLING
+        // the address is not acknowledged during the write cycle
+        _wire.beginTransmission(_address);
+        return _wire.endTransmission() == 0;
+#else
+        // each write operation is followed by a delay
+        return true;
+#endif
+    }
+
+    // wait until the write cycle has been completed
+    // returns false on timeout
+    bool waitReady()
+    {
+        uint32_t start = millis();
+        while (!isReady()) {
+            if (millis() - start > ARDUINO_EEPROM_I2C_WRITE_CYCLE_TIME) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+private:
+    // device address including the upper bits of the address
+    inline uint8_t _deviceAddress(uint32_t address) const
+    {
+        return _address | (uint8_t)(address >> (8 * _addressBytes));
+    }
+
+    inline void _beginTransmission(uint32_t address)
+    {
+        _wire.beginTransmission(_deviceAddress(address));
+        for (int8_t i = _addressBytes - 1; i >= 0; i--) {
+            _wire.write((uint8_t)(address >> (8 * i)));
+        }
+    }
+
+    bool _read(uint32_t address, uint8_t *data, uint16_t length)
+    {
+        if (!waitReady()) {
+            return false;
+        }
+        while (length) {
+            // sequential reads do not cross the boundary of the address bytes
+            uint32_t boundary = ((address >> (8 * _addressBytes)) + 1) << (8 * _addressBytes);
+            uint16_t len = length;
+            if (len > ARDUINO_EEPROM_I2C_BUFFER_SIZE) {
+                len = ARDUINO_EEPROM_I2C_BUFFER_SIZE;
+            }
+            if (address + len > boundary) {
+                len = boundary - address;
+            }
+            _beginTransmission(address);
+            if (_wire.endTransmission(false) != 0) {
+                return false;
+            }
+            if (_wire.requestFrom(_deviceAddress(address), (uint8_t)len) != len) {
+                return false;
+            }
+            for (uint16_t i = 0; i < len; i++) {
+                *data++ = _wire.read();
+            }
+            address += len;
+            length -= len;
+        }
+        return true;
+    }
+
+    bool _write(uint32_t address, const uint8_t *data, uint16_t length)
+    {
+        while (length) {
+            // page writes roll over at the end of the page
+            uint16_t len = _pageSize - (address % _pageSize);
+            if (len > ARDUINO_EEPROM_I2C_BUFFER_SIZE - _addressBytes) {
+                len = ARDUINO_EEPROM_I2C_BUFFER_SIZE - _addressBytes;
+            }
+            if (len > length) {
+                len = length;
+            }
+#if ARDUINO_EEPROM_I2C_ACK_POLLING
+            if (!waitReady()) {
+                return false;
+            }
+#endif
+            _beginTransmission(address);
+            _wire.write(data, len);
+            if (_wire.endTransmission() != 0) {
+                return false;
+            }
+#if !ARDUINO_EEPROM_I2C_ACK_POLLING
+            delay(ARDUINO_EEPROM_I2C_WRITE_CYCLE_TIME);
+#endif
+            address += len;
+            data += len;
+            length -= len;
+        }
+        return true;
+    }
+
+    TwoWire &_wire;
+    uint32_t _length;
+    uint16_t _pageSize;
+    uint8_t _address;
+    uint8_t _addressBytes;
+};
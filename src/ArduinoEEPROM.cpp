@@ -56,9 +56,15 @@ AssertClass assertClass;
 #define __ASSERT(...)                           _ASSERT_EXPR(__VA_ARGS__, assertClass._buffer)
 #define __ASSERT_ST_DATA(ofs, size)             (assertClass.inType(ArduinoEEPROMBase::ASSERT_DATA_TYPE::STATIC_DATA, ofs, size, staticDataOffset, staticDataLength))
 #define __ASSERT_WL_DATA(ofs, size)             (assertClass.inType(ArduinoEEPROMBase::ASSERT_DATA_TYPE::WEAR_LEVEL_DATA, ofs, size, wearLevelDataOffset, wearLevelDataLength))
+#define __ASSERT_CP_DATA(ofs, size)             (assertClass.inType(ArduinoEEPROMBase::ASSERT_DATA_TYPE::CHECKPOINT, ofs, size, checkpointOffset, checkpointLength))
+#define __ASSERT_EP_DATA(ofs, size)             (assertClass.inType(ArduinoEEPROMBase::ASSERT_DATA_TYPE::EPOCH, ofs, size, epochOffset, epochLength))
+#define __ASSERT_BB_DATA(ofs, size)             (assertClass.inType(ArduinoEEPROMBase::ASSERT_DATA_TYPE::BAD_BLOCKS, ofs, size, badBlocksOffset, badBlocksLength))
+#define __ASSERT_CN_DATA(ofs, size)             (assertClass.inType(ArduinoEEPROMBase::ASSERT_DATA_TYPE::COUNTER, ofs, size, counterOffset, counterLength))
+#define __ASSERT_RS_DATA(ofs, size)             (assertClass.inType(ArduinoEEPROMBase::ASSERT_DATA_TYPE::RECORDS, ofs, size, recordStoreOffset, recordStoreLength))
+#define __ASSERT_TS_DATA(ofs, size)             (assertClass.inType(ArduinoEEPROMBase::ASSERT_DATA_TYPE::TIME_SERIES, ofs, size, timeSeriesOffset, timeSeriesLength))
 
 // detect eeprom area by size of type...
-#define __ASSERT_DATA(ofs, size)                __ASSERT(__ASSERT_ST_DATA(ofs, size) || __ASSERT_WL_DATA(ofs, size))
+#define __ASSERT_DATA(ofs, size)                __ASSERT(__ASSERT_ST_DATA(ofs, size) || __ASSERT_WL_DATA(ofs, size) || __ASSERT_CP_DATA(ofs, size) || __ASSERT_EP_DATA(ofs, size) || __ASSERT_BB_DATA(ofs, size) || __ASSERT_CN_DATA(ofs, size) || __ASSERT_RS_DATA(ofs, size) || __ASSERT_TS_DATA(ofs, size))
 
 #define __ASSERT_SET_DATA_TYPE(type)            ArduinoEEPROMBase::_assertDataType = ArduinoEEPROMBase::ASSERT_DATA_TYPE::type
 
@@ -82,9 +88,32 @@ void ArduinoEEPROMBase::begin()
 {
 #if ARDUINO_EEPROM_AUTO_RESIZE
 #endif
+#if ARDUINO_EEPROM_HAVE_EPOCH
+    __ASSERT_SET_DATA_TYPE(EPOCH);
+    _readEpoch();
+#endif
+#if ARDUINO_EEPROM_HAVE_BAD_BLOCKS
+    __ASSERT_SET_DATA_TYPE(BAD_BLOCKS);
+    _readBadBlocks();
+#endif
+#if ARDUINO_EEPROM_HAVE_COUNTER
+    __ASSERT_SET_DATA_TYPE(COUNTER);
+    _readCounter();
+#endif
+#if ARDUINO_EEPROM_HAVE_RECORD_STORE
+    __ASSERT_SET_DATA_TYPE(RECORDS);
+    _readRecords();
+#endif
+#if ARDUINO_EEPROM_HAVE_TIME_SERIES
+    __ASSERT_SET_DATA_TYPE(TIME_SERIES);
+    _readTimeSeries();
+#endif
+    _wearLevelHeadOffset = INVALID_OFFSET;
+    _wearLevelHeadOffset = _getWearLevelHeadOffset(_wearLevelHeadCycleId);
+    _debug_printf_P(PSTR("head offset=%lu, cycleId=%lu\n"), (unsigned long)_wearLevelHeadOffset, (unsigned long)_wearLevelHeadCycleId);
 }
 
-void ArduinoEEPROMBase::eraseAndInitialize(DataTypeEnum type) const
+void ArduinoEEPROMBase::eraseAndInitialize(DataTypeEnum type)
 {
     if ((uint8_t)type & (uint8_t)DataTypeEnum::STATIC_DATA) {
         __ASSERT_SET_DATA_TYPE(STATIC_DATA);
@@ -92,8 +121,38 @@ void ArduinoEEPROMBase::eraseAndInitialize(DataTypeEnum type) const
     }
     if ((uint8_t)type & (uint8_t)DataTypeEnum::WEAR_LEVEL_DATA) {
         __ASSERT_SET_DATA_TYPE(WEAR_LEVEL_DATA);
-        _eraseAndInitialize(wearLevelDataOffset, wearLevelDataTypeSize, wearLevelNumBlocks);
+        _wearLevelHeadOffset = INVALID_OFFSET;
+#if ARDUINO_EEPROM_HAVE_EPOCH
+        _formatWearLevelData();
+#else
+        _eraseAndInitialize(wearLevelDataOffset, wearLevelPayloadSize, wearLevelNumBlocks);
+#endif
+#if ARDUINO_EEPROM_HAVE_CHECKPOINT
+        // zeros are an invalid checkpoint
+        __ASSERT_SET_DATA_TYPE(CHECKPOINT);
+        for (uint8_t i = 0; i < checkpointSlots; i++) {
+            _eepromClear(_getCheckpointOffset(i), sizeof(Checkpoint_t));
+        }
+#endif
+    }
+#if ARDUINO_EEPROM_HAVE_COUNTER
+    if ((uint8_t)type & (uint8_t)DataTypeEnum::COUNTER) {
+        __ASSERT_SET_DATA_TYPE(COUNTER);
+        _formatCounter();
+    }
+#endif
+#if ARDUINO_EEPROM_HAVE_RECORD_STORE
+    if ((uint8_t)type & (uint8_t)DataTypeEnum::RECORDS) {
+        __ASSERT_SET_DATA_TYPE(RECORDS);
+        _formatRecords();
     }
+#endif
+#if ARDUINO_EEPROM_HAVE_TIME_SERIES
+    if ((uint8_t)type & (uint8_t)DataTypeEnum::TIME_SERIES) {
+        __ASSERT_SET_DATA_TYPE(TIME_SERIES);
+        _formatTimeSeries();
+    }
+#endif
 }
 
 void ArduinoEEPROMBase::getBasicInfo(BasicInfo_t &info) const
@@ -111,8 +170,8 @@ void ArduinoEEPROMBase::getBasicInfo(BasicInfo_t &info) const
     info.staticData.copies = staticDataCopies;
     info.staticData.size = staticDataTypeSize;
 
-    uint32_t cycleId = 0;
-    auto offset = _getWearLevelOffset(cycleId);
+    uint32_t cycleId;
+    auto offset = _getWearLevelHeadOffset(cycleId);
 
     info.wearLevelData.valid = (offset != INVALID_OFFSET);
     info.wearLevelData.cycleId = cycleId;
@@ -156,10 +215,11 @@ uint8_t ArduinoEEPROMBase::writeStaticData(ConstByteAccessPointer data, uint8_t
 __ASSERT_SET_DATA_TYPE(STATIC_DATA);
 uint8_t result = 0;
 auto cycleId = _getStaticDataCycleId();
-if (cycleId++ == (uint32_t)~0) {
+if (cycleId == (uint32_t)~0) {
     _debug_printf_P(PSTR("cycleId=~0\n"));
     return false;
 }
+cycleId = _addCycleId(cycleId, 1);
 for (uint8_t i = 0; i < staticDataCopies; i++) {
     if (copiesBitset & _BV(i)) {
         if (_writeDataBlock(_getStaticDataOffset(i), cycleId, data, staticDataTypeSize)) {
@@ -171,33 +231,61 @@ _debug_printf_P(PSTR("result=%02x\n"), result);
 return result;
 }
 
+uint8_t ArduinoEEPROMBase::writeStaticDataIfModified(ConstByteAccessPointer data, uint8_t copiesBitset, bool *modified) const
+{
+    // all copies are written if any of them has been modified to keep the cycle ids in sync
+    bool result = isStaticDataModified(data, copiesBitset) != 0;
+    if (modified) {
+        *modified = result;
+    }
+    if (!result) {
+        return 0;
+    }
+    return writeStaticData(data, copiesBitset);
+}
+
 bool ArduinoEEPROMBase::isWearLevelDataModified(ConstByteAccessPointer data) const
 {
     __ASSERT_SET_DATA_TYPE(WEAR_LEVEL_DATA);
-    uint32_t cycleId = 0;
-    auto offset = _getWearLevelOffset(cycleId);
+    uint32_t cycleId;
+    auto offset = _getWearLevelHeadOffset(cycleId);
     if (offset == INVALID_OFFSET) {
         _debug_printf_P(PSTR("result=1\n"));
         return true;
     }
-    return _debug_print_result(_compareDataBlock(offset, data, wearLevelDataTypeSize) != 0);
+    return _debug_print_result(_compareWearLevelData(offset, data) != 0);
 }
 
 uint8_t ArduinoEEPROMBase::_compareDataBlock(EEPROMSizeType offset, ConstByteAccessPointer data, DataBlockSizeType size) const
 {
     DataBlockHeader_t header;
     __ASSERT_DATA(offset, sizeof(header));
-    offset = _eepromRead(offset, ByteAccessArray(&header), sizeof(header));
-    if (header.cycleId == 0) {
+    _eepromRead(offset, ByteAccessArray(&header), sizeof(header));
+    if (_isEmptyBlock(offset, header.cycleId)) {
         return 1;
     }
+    offset += sizeof(header);
 
-    CRCType crc = crc16_update(_dataBlockHeaderCrc(header), data, size);
+    BlockCRCType crc = _dataBlockCrcUpdate(_dataBlockHeaderCrc(header), data, size);
     if (header.crc != crc) {
         return 2;
     }
 
     __ASSERT_DATA(offset, size);
+    if (BlockAccess::hasBlockRead) {
+        uint8_t buffer[burstSize];
+        while (size) {
+            DataBlockSizeType len = min(size, (DataBlockSizeType)burstSize);
+            offset = _eepromRead(offset, ByteAccessArray(buffer), len);
+            for (DataBlockSizeType i = 0; i < len; i++) {
+                if (buffer[i] != *data++) {
+                    return 3;
+                }
+            }
+            size -= len;
+        }
+        return 0;
+    }
     for (EEPROMSizeType i = 0; i < size; i++) {
         if (_eeprom.read(offset++) != *data++) {
             return 3;
@@ -206,239 +294,1459 @@ uint8_t ArduinoEEPROMBase::_compareDataBlock(EEPROMSizeType offset, ConstByteAcc
     return 0;
 }
 
+uint8_t ArduinoEEPROMBase::_compareWearLevelData(EEPROMSizeType offset, ConstByteAccessPointer data) const
+{
+#if ARDUINO_EEPROM_HAVE_DELTA
+    // the data is decoded from the latest blocks
+    (void)offset;
+    uint8_t current[wearLevelDataTypeSize];
+    uint8_t depth;
+    if (!_readWearLevelDelta(current, 1, depth)) {
+        return 1;
+    }
+    for (DataBlockSizeType i = 0; i < wearLevelDataTypeSize; i++) {
+        if (current[i] != *data++) {
+            return 3;
+        }
+    }
+    return 0;
+#else
+    return _compareDataBlock(offset, data, wearLevelDataTypeSize);
+#endif
+}
+
 uint8_t ArduinoEEPROMBase::readWearLevelData(ByteAccessPointer data, uint8_t maxReadCopies) const
 {
     __ASSERT_SET_DATA_TYPE(WEAR_LEVEL_DATA);
-    uint32_t maxCycleId = ~0UL;
-    uint32_t cycleId = 0;
-    for (uint8_t i = 0; i < maxReadCopies; i++) {
-        auto offset = _getWearLevelOffset(cycleId, maxCycleId);
-        if (offset == INVALID_OFFSET) {
-            _debug_printf_P(PSTR("invalid offset, cycleId=%lu\n"), (unsigned long)cycleId);
-            break;
+    if (maxReadCopies == 0) {
+        return 0;
+    }
+#if ARDUINO_EEPROM_HAVE_DELTA
+    uint8_t current[wearLevelDataTypeSize];
+    uint8_t depth;
+    auto result = _readWearLevelDelta(current, min(maxReadCopies, ARDUINO_EEPROM_WEAR_LEVEL_MAX_READ_COPIES), depth);
+    if (result) {
+        for (DataBlockSizeType i = 0; i < wearLevelDataTypeSize; i++) {
+            *data++ = current[i];
         }
+    }
+    _debug_printf_P(PSTR("result=%u, patches=%u\n"), result, depth);
+    return result;
+#else
+    uint32_t cycleId;
+    auto offset = _getWearLevelHeadOffset(cycleId);
+    if (offset == INVALID_OFFSET) {
+        _debug_printf_P(PSTR("invalid offset\n"));
+        return 0;
+    }
 
-        DataBlockHeader_t header;
-        if (_readDataBlock(offset, data, wearLevelDataTypeSize, header)) {
-            _debug_printf_P(PSTR("result=%u\n"), i + 1);
-            return i + 1;
-        }
+    DataBlockHeader_t header;
+    if (_readDataBlock(offset, data, wearLevelDataTypeSize, header)) {
+        _debug_printf_P(PSTR("result=1\n"));
+        return 1;
+    }
 
-        // if a read error occured, read the previous block
-        if (header.cycleId == 1) {
-            break; // first block reached
+    // if a read error occured, read the previous blocks
+    // the candidates are collected with a single scan
+    WearLevelBlock_t blocks[ARDUINO_EEPROM_WEAR_LEVEL_MAX_READ_COPIES - 1];
+    auto count = _getWearLevelOffsets(blocks, min(maxReadCopies, ARDUINO_EEPROM_WEAR_LEVEL_MAX_READ_COPIES) - 1, cycleId);
+    for (uint8_t i = 0; i < count; i++) {
+        if (_readDataBlock(blocks[i].offset, data, wearLevelDataTypeSize, header)) {
+            _debug_printf_P(PSTR("result=%u\n"), i + 2);
+            return i + 2;
         }
-        maxCycleId = header.cycleId - 1;
-        _debug_printf_P(PSTR("maxCycleId=%lu\n"), (unsigned long)maxCycleId);
+        _debug_printf_P(PSTR("%04lx: error, cycleId=%lu\n"), (unsigned long)blocks[i].offset, (unsigned long)blocks[i].cycleId);
     }
     _debug_printf_P(PSTR("result=0\n"));
     return 0;
+#endif
 }
 
 uint8_t ArduinoEEPROMBase::writeWearLevelData(ConstByteAccessPointer data)
 {
-    uint8_t result = 0;
-    uint32_t maxCycleId = ~0UL;
-    uint32_t cycleId = 0;
-    auto offset = _getWearLevelOffset(cycleId, maxCycleId);
+    __ASSERT_SET_DATA_TYPE(WEAR_LEVEL_DATA);
+    uint32_t cycleId;
+    auto offset = _getWearLevelHeadOffset(cycleId);
     if (offset == INVALID_OFFSET) {
         _debug_printf_P(PSTR("invalid offset, cycleId=%lu\n"), (unsigned long)cycleId);
         return 0;
     }
+    return _writeWearLevelData(offset, cycleId, data);
+}
+
+uint8_t ArduinoEEPROMBase::writeWearLevelDataIfModified(ConstByteAccessPointer data, bool *modified)
+{
+    __ASSERT_SET_DATA_TYPE(WEAR_LEVEL_DATA);
+    uint32_t cycleId;
+    auto offset = _getWearLevelHeadOffset(cycleId);
+    bool result = (offset == INVALID_OFFSET) || (_compareWearLevelData(offset, data) != 0);
+    if (modified) {
+        *modified = result;
+    }
+    if (!result) {
+        _debug_printf_P(PSTR("not modified\n"));
+        return 0;
+    }
+    if (offset == INVALID_OFFSET) {
+        _debug_printf_P(PSTR("invalid offset\n"));
+        return 0;
+    }
+    return _writeWearLevelData(offset, cycleId, data);
+}
+
+uint8_t ArduinoEEPROMBase::_writeWearLevelData(EEPROMSizeType offset, uint32_t cycleId, ConstByteAccessPointer data)
+{
+    uint8_t result = 0;
+#if ARDUINO_EEPROM_HAVE_DELTA
+    uint8_t block[wearLevelPayloadSize];
+    DataBlockSizeType length = _encodeWearLevelDelta(data, block);
+#endif
+    _wearLevelHeadOffset = offset;
+    _wearLevelHeadCycleId = cycleId;
+#if ARDUINO_EEPROM_HAVE_CHECKPOINT
+    bool checkpoint = false;
+#endif
 
-    for (uint8_t i = 0; i < wearLevelDataCopies; i++) {
+#if ARDUINO_EEPROM_HAVE_BAD_BLOCKS
+    // a block that cannot be written is not retried, the copy is written to the next block
+    uint8_t failures = 0;
+    EEPROMSizeType blocks = 0;
+    while (result < wearLevelDataCopies && failures <= ARDUINO_EEPROM_WRITE_ERROR_RETRIES && blocks++ < wearLevelNumBlocks)
+#else
+    for (uint8_t i = 0; i < wearLevelDataCopies; i++)
+#endif
+    {
         offset += ARDUINO_EEPROM_ALIGN_LEN(wearLevelBlockSize);
         if (offset > wearLevelDataLastStartOffset) {
             offset = wearLevelDataOffset;
             _debugCycleCount++;
+#if ARDUINO_EEPROM_HAVE_CHECKPOINT
+            checkpoint = ((cycleId / wearLevelNumBlocks) % ARDUINO_EEPROM_CHECKPOINT_INTERVAL) == 0;
+#endif
+        }
+        cycleId = _addCycleId(cycleId, 1);
+        _debug_printf_P(PSTR("offset=%lu, cycleId=%lu\n"), (unsigned long)offset, (unsigned long)cycleId);
+#if ARDUINO_EEPROM_HAVE_BAD_BLOCKS
+        if (_isBadBlock(_getWearLevelBlockIndex(offset))) {
+            continue;
         }
-        cycleId++;
-        _debug_printf_P(PSTR("offset=%u, cycleId=%lu\n"), offset, (unsigned long)cycleId);
-        if (_writeDataBlock(offset, cycleId, data, wearLevelDataTypeSize)) {
-            result++;
+        constexpr uint8_t retries = 1;
+#else
+        constexpr uint8_t retries = ARDUINO_EEPROM_WRITE_ERROR_RETRIES;
+#endif
+#if ARDUINO_EEPROM_HAVE_DELTA
+        // the bytes following the patch are not written, but included in the CRC
+        _eepromRead(offset + sizeof(DataBlockHeader_t) + length, ByteAccessArray(block + length), wearLevelPayloadSize - length);
+        if (!_writeDataBlock(offset, cycleId, ConstByteAccessArray(block), wearLevelPayloadSize, retries))
+#else
+        if (!_writeDataBlock(offset, cycleId, data, wearLevelPayloadSize, retries))
+#endif
+        {
+#if ARDUINO_EEPROM_HAVE_BAD_BLOCKS
+            _markBadBlock(offset);
+            failures++;
+#endif
+            continue;
         }
+        // the latest valid block becomes the new head
+        _wearLevelHeadOffset = offset;
+        _wearLevelHeadCycleId = cycleId;
+        result++;
+    }
+
+#if ARDUINO_EEPROM_HAVE_CHECKPOINT
+    if (checkpoint && result) {
+        __ASSERT_SET_DATA_TYPE(CHECKPOINT);
+        _writeCheckpoint(_wearLevelHeadOffset, _wearLevelHeadCycleId);
     }
+#endif
 
     _debug_printf_P(PSTR("result=%u\n"), result);
     return result;
 }
 
-#if ARDUINO_EEPROM_HAVE_DUMP
+#if ARDUINO_EEPROM_HAVE_DELTA
 
-void ArduinoEEPROMBase::dumpOffsets(Print &output) const
+uint8_t ArduinoEEPROMBase::_readWearLevelDelta(uint8_t *data, uint8_t maxReadCopies, uint8_t &depth, EEPROMSizeType offset, uint32_t cycleId) const
 {
-    Serial_printf_P(
-        PSTR(
-            "page size:        %u\n"
-            "start:            %u:%u\n"
-            "static:           %u:%u (copies %u, size %u/%u/%u)\n"
-            "end:              %u\n"
-            "wear level:       %u:%u (blocks %u, cycles %u, copies %u, size %u/%u/%u)\n"
-            "end:              %u\n"
-            "unused:           %u:%u\n"
-            "eeprom end:       %u\n"
-        ),
-        pageSize,
-        startOffset, eepromLength,
-        staticDataOffset, staticDataLength,
-        staticDataCopies, staticDataTypeSize, staticDataBlockSize, ARDUINO_EEPROM_ALIGN_LEN(staticDataBlockSize),
-        staticDataOffset + staticDataLength - 1,
-        wearLevelDataOffset, wearLevelDataLength,
-        wearLevelNumBlocks, wearLevelNumCycles, wearLevelDataCopies, wearLevelDataTypeSize, wearLevelBlockSize, ARDUINO_EEPROM_ALIGN_LEN(wearLevelBlockSize),
-        wearLevelDataOffset + wearLevelDataLength - 1,
-        wearLevelDataOffset + wearLevelDataLength,
-        eepromUnusedBytes,
-        startOffset + eepromLength - 1
-    );
+    depth = 0;
+    if (offset == INVALID_OFFSET) {
+        offset = _getWearLevelHeadOffset(cycleId);
+    }
+    if (offset == INVALID_OFFSET) {
+        _debug_printf_P(PSTR("invalid offset\n"));
+        return 0;
+    }
+
+    // walk backwards and collect the latest block of each record. the copies of a record are identical and
+    // the number of patches decreases by one with each record until the snapshot has been reached
+    EEPROMSizeType records[deltaSnapshotInterval];
+    uint8_t skipped = 0;
+    uint8_t last = 0;
+    bool found = false;
+    EEPROMSizeType index = _getWearLevelBlockIndex(offset);
+    for (EEPROMSizeType i = 0; i < wearLevelNumBlocks; i++) {
+        if (!_isBadBlock(index)) {
+            offset = _getWearLevelBlockOffset(index);
+            DataBlockHeader_t header;
+            _eepromRead(offset, ByteAccessArray(&header), sizeof(header));
+            if (_isEmptyBlock(offset, header.cycleId)) {
+                break;
+            }
+            // copies of a record that has been collected already are not validated
+            uint8_t n = _eeprom.read(offset + sizeof(header));
+            if (!found || n != last || header.cycleId != cycleId) {
+                if (!_validateEepromDataBlockCrc(offset, wearLevelPayloadSize, header)) {
+                    if (!found && ++skipped >= maxReadCopies) {
+                        _debug_printf_P(PSTR("%04lx: error, skipped=%u\n"), (unsigned long)offset, skipped);
+                        return 0;
+                    }
+                }
+                else if (header.cycleId != cycleId) {
+                    // data from the previous cycle
+                    break;
+                }
+                else {
+                    if (!found) {
+                        if (n >= deltaSnapshotInterval) {
+                            return 0;
+                        }
+                        found = true;
+                        depth = n;
+                        last = n;
+                        records[n] = offset;
+                    }
+                    else if (n > last || n + 1 < last) {
+                        _debug_printf_P(PSTR("%04lx: patch=%u, expected=%u\n"), (unsigned long)offset, n, last - 1);
+                        return 0;
+                    }
+                    else {
+                        last = n;
+                        records[n] = offset;
+                    }
+                    if (last == 0) {
+                        break;
+                    }
+                }
+            }
+        }
+        cycleId = _addCycleId(cycleId, -1);
+        index = (index ? index : wearLevelNumBlocks) - 1;
+    }
+    if (!found || last != 0) {
+        _debug_printf_P(PSTR("no snapshot, patches=%u\n"), depth);
+        return 0;
+    }
+
+    // apply the patches to the snapshot. the data must match the CRC stored in the patch
+    _eepromRead(records[0] + sizeof(DataBlockHeader_t) + 1, ByteAccessArray(data), wearLevelDataTypeSize);
+    for (uint8_t n = 1; n <= depth; n++) {
+        // the modified bytes follow the bitmap
+        uint8_t block[1 + sizeof(BlockCRCType) + deltaBitmapSize];
+        auto offset = _eepromRead(records[n] + sizeof(DataBlockHeader_t), ByteAccessArray(block), sizeof(block));
+        BlockCRCType crc;
+        memcpy(&crc, &block[1], sizeof(crc));
+        if (crc != BlockCRC::update((BlockCRCType)~0, data, wearLevelDataTypeSize)) {
+            _debug_printf_P(PSTR("%04lx: CRC mismatch, patch=%u\n"), (unsigned long)records[n], n);
+            return 0;
+        }
+        const uint8_t *bitmap = &block[1 + sizeof(crc)];
+        for (DataBlockSizeType i = 0; i < wearLevelDataTypeSize; i++) {
+            if (bitmap[i / 8] & _BV(i % 8)) {
+                if (offset == records[n] + sizeof(DataBlockHeader_t) + wearLevelPayloadSize) {
+                    return 0;
+                }
+                data[i] = _eeprom.read(offset++);
+            }
+        }
+    }
+    return skipped + 1;
 }
 
-void ArduinoEEPROMBase::dump(Print &output, DataTypeEnum type) const
+ArduinoEEPROMBase::DataBlockSizeType ArduinoEEPROMBase::_encodeWearLevelDelta(ConstByteAccessPointer data, uint8_t *block) const
 {
-    uint8_t copies = ~0;
-    uint8_t valid = 0;
-    uint32_t cycleId = _getStaticDataCycleIdAndBitset(copies);
-    char buf[staticDataCopies + 1];
-    uint8_t i = 0;
-    for (; i < staticDataCopies; i++) {
-        if (copies & _BV(i)) {
-            buf[i] = '1';
-            valid++;
+    // number of patches, CRC of the previous data, bitmap and the modified bytes
+    uint8_t previous[wearLevelDataTypeSize];
+    uint8_t depth;
+    if (1 + sizeof(BlockCRCType) + deltaBitmapSize < wearLevelPayloadSize && _readWearLevelDelta(previous, wearLevelDataCopies, depth) && depth + 1 < deltaSnapshotInterval) {
+        uint8_t *bitmap = &block[1 + sizeof(BlockCRCType)];
+        uint8_t *ptr = bitmap + deltaBitmapSize;
+        memset(bitmap, 0, deltaBitmapSize);
+        auto src = data;
+        DataBlockSizeType i;
+        for (i = 0; i < wearLevelDataTypeSize; i++) {
+            uint8_t byte = *src++;
+            if (byte != previous[i]) {
+                // the patch must be smaller than the snapshot
+                if (ptr == block + wearLevelPayloadSize - 1) {
+                    break;
+                }
+                bitmap[i / 8] |= _BV(i % 8);
+                *ptr++ = byte;
+            }
         }
-        else {
-            buf[i] = 'x';
+        if (i == wearLevelDataTypeSize) {
+            BlockCRCType crc = BlockCRC::update((BlockCRCType)~0, previous, wearLevelDataTypeSize);
+            block[0] = depth + 1;
+            memcpy(&block[1], &crc, sizeof(crc));
+            _debug_printf_P(PSTR("patch=%u, length=%u\n"), block[0], (unsigned)(ptr - block));
+            return ptr - block;
         }
     }
-    buf[i] = 0;
-
-    dumpOffsets(output);
+    block[0] = 0;
+    for (DataBlockSizeType i = 0; i < wearLevelDataTypeSize; i++) {
+        block[i + 1] = *data++;
+    }
+    _debug_printf_P(PSTR("snapshot\n"));
+    return wearLevelPayloadSize;
+}
 
-    Serial_printf_P(PSTR("Static data: %u / %u (%s)\n"), valid, staticDataCopies, buf);
+#endif
 
-    cycleId = 0;
-    auto offset = _getWearLevelOffset(cycleId);
-    Serial_printf_P(PSTR("Wear level: offset = %u, cycle id = %lu\n"),
-        offset,
-        (unsigned long)cycleId
-    );
-    Serial_printf_P(PSTR("_debugCycleCount=%lu\n"), (unsigned long)_debugCycleCount);
-    //Serial_printf_P(PSTR("size=%u,data=%u,overhead=%u,redundant=%u,unused=%u\n"),
-    //    eepromLength,
-    //    staticDataTypeSize + (wearLevelDataTypeSize * wearLevelNumCycles),
-    //    (sizeof(DataBlockHeader_t) * (staticDataCopies + wearLevelNumBlocks)) + (staticDataOffset - startOffset),
-    //    (staticDataTypeSize * (staticDataCopies - 1)) + (wearLevelDataTypeSize * (wearLevelDataCopies - 1) * (wearLevelNumBlocks / wearLevelDataCopies)),
-    //    eepromUnusedBytes
-    //);
+#if ARDUINO_EEPROM_HAVE_HISTORY
 
-    if ((uint8_t)type & (uint8_t)DataTypeEnum::STATIC_DATA) {
-        __ASSERT_SET_DATA_TYPE(STATIC_DATA);
-        Serial.println(F("Ofs   CRC  CycleId  Status"));
-        EEPROMSizeType offset = staticDataOffset;
-        DataBlockHeader_t header;
-        for (uint8_t i = 0; i < staticDataCopies; i++) {
-            auto result = _validateEepromDataBlockCrc(offset, staticDataTypeSize, header);
-            Serial_printf_P(PSTR("%04x: %04x %08lx %s\n"), offset, header.crc, (unsigned long)header.cycleId, header.cycleId ? (result ? "GOOD" : "BAD") : "EMPTY");
-            offset += ARDUINO_EEPROM_ALIGN_LEN(staticDataBlockSize);
+bool ArduinoEEPROMBase::beginHistory(HistoryIterator_t &iterator, uint32_t newestCycleId, uint32_t oldestCycleId) const
+{
+    __ASSERT_SET_DATA_TYPE(WEAR_LEVEL_DATA);
+    iterator.cycleId = 0;
+    iterator.oldestCycleId = oldestCycleId;
+    iterator.copies = wearLevelDataCopies;
+    iterator.remaining = 0;
+    uint32_t cycleId;
+    auto offset = _getWearLevelHeadOffset(cycleId);
+    if (offset == INVALID_OFFSET || cycleId == 0) {
+        _debug_printf_P(PSTR("invalid offset\n"));
+        return false;
+    }
+    uint32_t distance = 0;
+    if (newestCycleId != (uint32_t)~0 && _isNewerCycleId(cycleId, newestCycleId)) {
+        distance = _getCycleIdDistance(cycleId, newestCycleId);
+        if (distance >= wearLevelNumBlocks) {
+            _debug_printf_P(PSTR("cycleId=%lu overwritten\n"), (unsigned long)newestCycleId);
+            return false;
         }
+        cycleId = newestCycleId;
     }
+    auto index = _getWearLevelBlockIndex(offset);
+    iterator.index = (index >= distance) ? index - distance : index + wearLevelNumBlocks - distance;
+    iterator.nextCycleId = cycleId;
+    iterator.remaining = wearLevelNumBlocks - distance;
+    return true;
+}
 
-    if ((uint8_t)type & (uint8_t)DataTypeEnum::WEAR_LEVEL_DATA) {
-        __ASSERT_SET_DATA_TYPE(WEAR_LEVEL_DATA);
-        Serial.println(F("Ofs Cycle CRC  CycleId  Status"));
-
-        EEPROMSizeType offset = wearLevelDataOffset;
-        DataBlockHeader_t header;
-        uint8_t n = 1;
-        while (offset <= wearLevelDataLastStartOffset) {
-            Serial_printf_P(PSTR("%u/%u "), n++, wearLevelNumBlocks);
-            auto result = _validateEepromDataBlockCrc(offset, wearLevelDataTypeSize, header);
-            auto cycle = (unsigned)(((header.cycleId - 1) / wearLevelDataCopies) % (wearLevelNumCycles));
-            Serial_printf_P(PSTR("ofs=%04x "), offset);
-            if (!result) {
-                Serial_printf_P(PSTR("cycle=%u cycleId=%lu invalid data, error\n"), cycle, (unsigned long)(header.cycleId));
-            }
-            else {
-                Serial_printf_P(PSTR("cycle=%u cycleId=%lu %s\n"), cycle, (unsigned long)header.cycleId, header.cycleId ? (result ? "GOOD" : "BAD") : "EMPTY");
-            }
-            offset += ARDUINO_EEPROM_ALIGN_LEN(wearLevelBlockSize);
+bool ArduinoEEPROMBase::readHistory(HistoryIterator_t &iterator, ByteAccessPointer data) const
+{
+    __ASSERT_SET_DATA_TYPE(WEAR_LEVEL_DATA);
+    uint8_t current[wearLevelDataTypeSize];
+    for (; iterator.remaining; iterator.remaining--) {
+        auto index = iterator.index;
+        auto cycleId = iterator.nextCycleId;
+        iterator.index = (index ? index : wearLevelNumBlocks) - 1;
+        iterator.nextCycleId = _addCycleId(cycleId, -1);
+        if (_isBadBlock(index)) {
+            continue;
+        }
+        if (_isNewerCycleId(iterator.oldestCycleId, cycleId)) {
+            break;
+        }
+        auto result = _readHistoryBlock(_getWearLevelBlockOffset(index), cycleId, current);
+        if (result < 0) {
+            // the oldest record has been read
+            break;
+        }
+        if (iterator.copies < wearLevelDataCopies) {
+            iterator.copies++;
+        }
+        if (result == 0) {
+            continue;
+        }
+        // the copies of a record are stored in the following blocks that are not marked as bad. if the latest copy
+        // cannot be read, the records are not aligned to the blocks and copies are detected by the CRC of the data
+        BlockCRCType crc = BlockCRC::update((BlockCRCType)~0, current, wearLevelDataTypeSize);
+        if (iterator.copies < wearLevelDataCopies && crc == iterator.crc) {
+            continue;
+        }
+        iterator.cycleId = cycleId;
+        iterator.crc = crc;
+        iterator.copies = 0;
+        iterator.remaining--;
+        for (DataBlockSizeType i = 0; i < wearLevelDataTypeSize; i++) {
+            *data++ = current[i];
         }
+        return true;
     }
+    iterator.remaining = 0;
+    return false;
 }
 
-void ArduinoEEPROMBase::dumpBasicInfo(Print &output, const BasicInfo_t &info) const
+bool ArduinoEEPROMBase::readHistory(uint32_t cycleId, ByteAccessPointer data) const
 {
-    Serial_printf_P(PSTR("valid=%u/%u, write cyles=%lu, size=%u\n"), info.staticData.valid, info.staticData.copies, (unsigned long)info.staticData.writeCycles, info.staticData.size);
-    Serial_printf_P(PSTR("valid=%u, write cycles=%lu, cycle id=%lu, size=%u\n"), info.wearLevelData.valid, (unsigned long)info.wearLevelData.writeCycles, (unsigned long)info.wearLevelData.cycleId, info.wearLevelData.size);
+    __ASSERT_SET_DATA_TYPE(WEAR_LEVEL_DATA);
+    uint32_t headCycleId;
+    auto offset = _getWearLevelHeadOffset(headCycleId);
+    if (offset == INVALID_OFFSET || cycleId == 0 || _isNewerCycleId(cycleId, headCycleId)) {
+        return false;
+    }
+    uint32_t distance = _getCycleIdDistance(headCycleId, cycleId);
+    if (distance >= wearLevelNumBlocks) {
+        return false;
+    }
+    auto index = _getWearLevelBlockIndex(offset);
+    index = (index >= distance) ? index - distance : index + wearLevelNumBlocks - distance;
+    if (_isBadBlock(index)) {
+        return false;
+    }
+    uint8_t current[wearLevelDataTypeSize];
+    if (_readHistoryBlock(_getWearLevelBlockOffset(index), cycleId, current) <= 0) {
+        return false;
+    }
+    for (DataBlockSizeType i = 0; i < wearLevelDataTypeSize; i++) {
+        *data++ = current[i];
+    }
+    return true;
 }
 
-#endif
-
-void ArduinoEEPROMBase::_eraseAndInitialize(EEPROMSizeType offset, DataBlockSizeType size, EEPROMSizeType numBlocks) const
+int8_t ArduinoEEPROMBase::_readHistoryBlock(EEPROMSizeType offset, uint32_t cycleId, uint8_t *data) const
 {
     DataBlockHeader_t header;
-
-    header.cycleId = 0;
-    header.crc = _dataBlockHeaderCrc(header);;
-    for (WearLevelCyclesType i = 0; i < size; i++) {
-        header.crc = _crc16_update(header.crc, 0);
+#if ARDUINO_EEPROM_HAVE_DELTA
+    uint8_t depth;
+    if (_readWearLevelDelta(data, 1, depth, offset, cycleId)) {
+        return 1;
+    }
+    // patches cannot be applied if the snapshot has been overwritten
+    bool valid = _validateEepromDataBlockCrc(offset, wearLevelPayloadSize, header);
+#else
+    bool valid = _readDataBlock(offset, ByteAccessArray(data), wearLevelDataTypeSize, header);
+    if (valid && header.cycleId == cycleId) {
+        return 1;
     }
-#if ARDUINO_EEPROM_PAGE_SIZE > 1
-    // extra space till next page
-    uint8_t extra = ARDUINO_EEPROM_ALIGN_LEN(size + sizeof(header)) - (size + sizeof(header));
-#endif
-    for (uint16_t i = 0; i < numBlocks; i++) {
-        __ASSERT_DATA(offset, sizeof(header));
-        offset = _eepromWrite(offset, ConstByteAccessArray(&header), sizeof(header));
-        __ASSERT_DATA(offset, size);
-        offset = _eepromClear(offset, size);
-#if ARDUINO_EEPROM_PAGE_SIZE > 1
-        offset += extra;
 #endif
+    if (_isEmptyBlock(offset, header.cycleId) || (valid && header.cycleId != cycleId)) {
+        return -1;
     }
+    return 0;
 }
 
-uint32_t ArduinoEEPROMBase::_getStaticDataCycleIdAndBitset(uint8_t &copiesBitset, uint32_t *cycleIds) const
-{
-    uint32_t maxCycleId = 0;
-    uint32_t cycleIdsTmp[staticDataCopies];
-    DataBlockHeader_t header;
+#endif
 
-    __ASSERT_SET_DATA_TYPE(STATIC_DATA);
+#if ARDUINO_EEPROM_HAVE_CHECKPOINT
 
-    if (!cycleIds) {
-        cycleIds = cycleIdsTmp;
+bool ArduinoEEPROMBase::writeCheckpoint()
+{
+    uint32_t cycleId;
+    auto offset = _getWearLevelHeadOffset(cycleId);
+    if (offset == INVALID_OFFSET || cycleId == _epochCycleId) {
+        _debug_printf_P(PSTR("invalid offset\n"));
+        return false;
     }
+    __ASSERT_SET_DATA_TYPE(CHECKPOINT);
+    return _writeCheckpoint(offset, cycleId);
+}
 
-    memset(cycleIds, 0xff, sizeof(cycleIdsTmp));
+#endif
 
-    for (uint8_t i = 0; i < staticDataCopies; i++) {
-        if (copiesBitset & _BV(i)) {
-            if (_validateEepromDataBlockCrc(_getStaticDataOffset(i), staticDataTypeSize, header)) {
-                cycleIds[i] = header.cycleId;
-                maxCycleId = max(maxCycleId, header.cycleId);
-            }
-        }
-    }
+#if ARDUINO_EEPROM_HAVE_ASYNC_WRITE
 
-    copiesBitset = 0;
-    for (uint8_t i = 0; i < staticDataCopies; i++) {
-        if (maxCycleId == cycleIds[i]) {
-            copiesBitset |= _BV(i);
-        }
+bool ArduinoEEPROMBase::writeStaticDataAsync(ConstByteAccessPointer data, uint8_t copiesBitset)
+{
+    if (_async.pending) {
+        _debug_printf_P(PSTR("write operation pending\n"));
+        return false;
     }
-    return maxCycleId;
+    auto cycleId = _getStaticDataCycleId();
+    if (cycleId == (uint32_t)~0) {
+        _debug_printf_P(PSTR("cycleId=~0\n"));
+        return false;
+    }
+    cycleId = _addCycleId(cycleId, 1);
+    for (DataBlockSizeType i = 0; i < staticDataTypeSize; i++) {
+        _async.data[i] = *data++;
+    }
+    _async.type = DataTypeEnum::STATIC_DATA;
+    _async.size = staticDataTypeSize;
+    _async.header.cycleId = cycleId;
+    _async.copy = 0;
+    _async.copiesBitset = copiesBitset;
+    _async.result = 0;
+    _async.pending = true;
+    _nextAsyncBlock();
+    return true;
 }
 
-uint32_t ArduinoEEPROMBase::_getStaticDataCycleId() const
+bool ArduinoEEPROMBase::writeWearLevelDataAsync(ConstByteAccessPointer data)
 {
-    uint8_t copiesBitset = ~0;
-    auto cycleId = _getStaticDataCycleIdAndBitset(copiesBitset, nullptr);
-    if (copiesBitset) {
-        return cycleId;
+    if (_async.pending) {
+        _debug_printf_P(PSTR("write operation pending\n"));
+        return false;
     }
-    return ~0;
+    uint32_t cycleId;
+    auto offset = _getWearLevelHeadOffset(cycleId);
+    if (offset == INVALID_OFFSET) {
+        _debug_printf_P(PSTR("invalid offset\n"));
+        return false;
+    }
+    _wearLevelHeadOffset = offset;
+    _wearLevelHeadCycleId = cycleId;
+
+#if ARDUINO_EEPROM_HAVE_DELTA
+    _async.length = _encodeWearLevelDelta(data, _async.data);
+#else
+    for (DataBlockSizeType i = 0; i < wearLevelDataTypeSize; i++) {
+        _async.data[i] = *data++;
+    }
+#endif
+    _async.type = DataTypeEnum::WEAR_LEVEL_DATA;
+    _async.size = wearLevelPayloadSize;
+    _async.offset = offset;
+    _async.header.cycleId = cycleId;
+    _async.copy = 0;
+    _async.result = 0;
+#if ARDUINO_EEPROM_HAVE_BAD_BLOCKS
+    _async.failures = 0;
+#endif
+    _async.pending = true;
+    _nextAsyncBlock();
+    return true;
 }
 
-#if !_MSC_VER || !DEBUG
+bool ArduinoEEPROMBase::poll()
+{
+    if (!_async.pending) {
+        return true;
+    }
+    if (!ARDUINO_EEPROM_IS_READY()) {
+        return false;
+    }
+
+    // payload first and the header last. an incomplete block has a CRC mismatch
+    DataBlockSizeType total = _async.size + sizeof(DataBlockHeader_t);
+    while (_async.position < total) {
+        EEPROMSizeType offset;
+        uint8_t byte;
+        if (_async.position < _async.size) {
+            offset = _async.offset + sizeof(DataBlockHeader_t) + _async.position;
+            byte = _async.data[_async.position];
+        }
+        else {
+            offset = _async.offset + (_async.position - _async.size);
+            byte = reinterpret_cast<const uint8_t *>(&_async.header)[_async.position - _async.size];
+        }
+        _async.position++;
+        __ASSERT_DATA(offset, 1);
+        if (_eeprom.read(offset) != byte) {
+            _eeprom.write(offset, byte);
+            return false;
+        }
+    }
+
+    // the header must match, a block that cannot be written anymore might still contain an older valid block
+    DataBlockHeader_t header;
+    if (_validateEepromDataBlockCrc(_async.offset, _async.size, header) && memcmp(&header, &_async.header, sizeof(header)) == 0) {
+        if (_async.type == DataTypeEnum::STATIC_DATA) {
+            _async.result |= _BV(_async.copy - 1);
+        }
+        else {
+            _wearLevelHeadOffset = _async.offset;
+            _wearLevelHeadCycleId = _async.header.cycleId;
+            _async.result++;
+        }
+    }
+#if ARDUINO_EEPROM_HAVE_BAD_BLOCKS
+    else if (_async.type == DataTypeEnum::WEAR_LEVEL_DATA) {
+        // continue with the next block, the copy is not counted
+        _debug_printf_P(PSTR("%04lx: error, failures=%u\n"), (unsigned long)_async.offset, _async.failures + 1);
+        _markBadBlock(_async.offset);
+        if (_async.failures++ < ARDUINO_EEPROM_WRITE_ERROR_RETRIES) {
+            _async.copy--;
+        }
+    }
+#endif
+    else if (++_async.retries < ARDUINO_EEPROM_WRITE_ERROR_RETRIES) {
+        _debug_printf_P(PSTR("%04lx: error, retry=%u\n"), (unsigned long)_async.offset, _async.retries);
+        _async.position = 0;
+        return false;
+    }
+    _nextAsyncBlock();
+    return !_async.pending;
+}
+
+void ArduinoEEPROMBase::flushAsync()
+{
+    while (!poll()) {
+    }
+}
+
+uint8_t ArduinoEEPROMBase::getAsyncResult() const
+{
+    return _async.result;
+}
+
+void ArduinoEEPROMBase::_nextAsyncBlock()
+{
+    if (_async.type == DataTypeEnum::STATIC_DATA) {
+        __ASSERT_SET_DATA_TYPE(STATIC_DATA);
+        while (_async.copy < staticDataCopies && !(_async.copiesBitset & _BV(_async.copy))) {
+            _async.copy++;
+        }
+        if (_async.copy >= staticDataCopies) {
+            _debug_printf_P(PSTR("result=%02x\n"), _async.result);
+            _async.pending = false;
+            return;
+        }
+        _async.offset = _getStaticDataOffset(_async.copy);
+    }
+    else {
+        __ASSERT_SET_DATA_TYPE(WEAR_LEVEL_DATA);
+        if (_async.copy >= wearLevelDataCopies) {
+            _debug_printf_P(PSTR("result=%u\n"), _async.result);
+            _async.pending = false;
+            return;
+        }
+        EEPROMSizeType blocks = 0;
+        do {
+            if (blocks++ == wearLevelNumBlocks) {
+                _debug_printf_P(PSTR("no valid block\n"));
+                _async.pending = false;
+                return;
+            }
+            _async.offset += ARDUINO_EEPROM_ALIGN_LEN(wearLevelBlockSize);
+            if (_async.offset > wearLevelDataLastStartOffset) {
+                _async.offset = wearLevelDataOffset;
+                _debugCycleCount++;
+            }
+            _async.header.cycleId = _addCycleId(_async.header.cycleId, 1);
+        } while (_isBadBlock(_getWearLevelBlockIndex(_async.offset)));
+#if ARDUINO_EEPROM_HAVE_DELTA
+        // the bytes following the patch are included in the CRC. poll() skips them since they do not differ
+        _eepromRead(_async.offset + sizeof(DataBlockHeader_t) + _async.length, ByteAccessArray(_async.data + _async.length), wearLevelPayloadSize - _async.length);
+#endif
+    }
+    _async.copy++;
+    _setDataBlockHeaderCycleId(_async.header, _async.header.cycleId);
+    _async.header.crc = _dataBlockCrcUpdate(_dataBlockHeaderCrc(_async.header), ConstByteAccessArray(_async.data), _async.size);
+    _async.position = 0;
+    _async.retries = 0;
+    _debug_printf_P(PSTR("offset=%lu, cycleId=%lu\n"), (unsigned long)_async.offset, (unsigned long)_async.header.cycleId);
+}
+
+#endif
+
+#if ARDUINO_EEPROM_HAVE_COUNTER
+
+bool ArduinoEEPROMBase::incrementCounter()
+{
+    __ASSERT_SET_DATA_TYPE(COUNTER);
+    if (_counterPosition >= counterLogSize) {
+        // all markers have been written, the log is reused with the other marker after writing the checkpoint
+        uint32_t value = _counterValue + counterLogSize;
+        if (value < _counterValue) {
+            _debug_printf_P(PSTR("max. value\n"));
+            return false;
+        }
+        uint8_t slot = (_counterSlot == 0) ? 1 : 0;
+        if (!_writeCounterCheckpoint(slot, value)) {
+            return false;
+        }
+        _counterValue = value;
+        _counterSlot = slot;
+        _counterPosition = 0;
+    }
+
+    // write the marker to the next byte. the bytes of previous increments are not modified
+    uint8_t data = _getCounterLogMarker(_counterValue);
+    EEPROMSizeType offset = counterLogOffset + _counterPosition;
+    _eepromWrite(offset, ConstByteAccessArray(&data), sizeof(data));
+    uint8_t tmp;
+    _eepromRead(offset, ByteAccessArray(&tmp), sizeof(tmp));
+    if (tmp != data) {
+        _debug_printf_P(PSTR("%04lx: error\n"), (unsigned long)offset);
+        return false;
+    }
+    _counterPosition++;
+    return true;
+}
+
+uint32_t ArduinoEEPROMBase::readCounter() const
+{
+    return _counterValue + _counterPosition;
+}
+
+uint8_t ArduinoEEPROMBase::_readCounter()
+{
+    _counterValue = 0;
+    _counterSlot = INVALID_COUNTER_CHECKPOINT;
+    for (uint8_t i = 0; i < counterSlots; i++) {
+        CounterCheckpoint_t tmp;
+        _eepromRead(_getCounterCheckpointOffset(i), ByteAccessArray(&tmp), sizeof(tmp));
+        if (tmp.crc != CRC::update((CRCType)~0, &tmp.value, sizeof(tmp.value)) || (tmp.value % counterLogSize) != 0) {
+            continue;
+        }
+        if (_counterSlot == INVALID_COUNTER_CHECKPOINT || tmp.value > _counterValue) {
+            _counterValue = tmp.value;
+            _counterSlot = i;
+        }
+    }
+
+    // the log starts with the markers of the checkpoint, followed by bytes that contain the marker of the previous
+    // checkpoint or a byte of an interrupted write operation
+    uint8_t marker = _getCounterLogMarker(_counterValue);
+    uint16_t low = 0;                                   // first byte without marker
+    uint16_t high = counterLogSize;
+    while (low < high) {
+        uint16_t mid = low + ((high - low) / 2);
+        uint8_t data;
+        _eepromRead(counterLogOffset + mid, ByteAccessArray(&data), sizeof(data));
+        if (data == marker) {
+            low = mid + 1;
+        }
+        else {
+            high = mid;
+        }
+    }
+    _counterPosition = low;
+    _debug_printf_P(PSTR("slot=%u, checkpoint=%lu, position=%u\n"), _counterSlot, (unsigned long)_counterValue, _counterPosition);
+    return _counterSlot;
+}
+
+bool ArduinoEEPROMBase::_writeCounterCheckpoint(uint8_t slot, uint32_t value)
+{
+    CounterCheckpoint_t checkpoint;
+    checkpoint.value = value;
+    checkpoint.crc = CRC::update((CRCType)~0, &checkpoint.value, sizeof(checkpoint.value));
+
+    _debug_printf_P(PSTR("slot=%u, checkpoint=%lu\n"), slot, (unsigned long)value);
+
+    // the previous checkpoint and the log remain valid if the write operation gets interrupted
+    auto offset = _getCounterCheckpointOffset(slot);
+    _eepromWrite(offset, ConstByteAccessArray(&checkpoint), sizeof(checkpoint));
+    CounterCheckpoint_t tmp;
+    _eepromRead(offset, ByteAccessArray(&tmp), sizeof(tmp));
+    return memcmp(&tmp, &checkpoint, sizeof(tmp)) == 0;
+}
+
+void ArduinoEEPROMBase::_formatCounter()
+{
+    // zeros are an invalid checkpoint
+    for (uint8_t i = 0; i < counterSlots; i++) {
+        _eepromClear(_getCounterCheckpointOffset(i), sizeof(CounterCheckpoint_t));
+    }
+    _counterValue = 0;
+    _counterPosition = 0;
+    _counterSlot = INVALID_COUNTER_CHECKPOINT;
+
+    // zeros do not match any marker
+    _eepromClear(counterLogOffset, counterLogSize);
+}
+
+ArduinoEEPROMBase::EEPROMSizeType ArduinoEEPROMBase::_getCounterCheckpointOffset(uint8_t slot) const
+{
+    return counterOffset + (slot * ARDUINO_EEPROM_ALIGN_LEN(sizeof(CounterCheckpoint_t)));
+}
+
+#endif
+
+#if ARDUINO_EEPROM_HAVE_TIME_SERIES
+
+bool ArduinoEEPROMBase::appendSample(ConstByteAccessPointer data)
+{
+    __ASSERT_SET_DATA_TYPE(TIME_SERIES);
+    if (_timeSeriesCycleId == 0 || _timeSeriesCount >= timeSeriesSamplesPerPage) {
+        // the oldest page is reused
+        EEPROMSizeType page = _timeSeriesCycleId ? (_timeSeriesPage + 1) % timeSeriesNumPages : 0;
+        uint32_t cycleId = _addCycleId(_timeSeriesCycleId, 1);
+        if (!_beginTimeSeriesPage(page, cycleId)) {
+            return false;
+        }
+        _timeSeriesPage = page;
+        _timeSeriesCycleId = cycleId;
+        _timeSeriesCount = 0;
+    }
+
+    // the marker is written after the sample. if the write operation gets interrupted, the sample is not valid
+    // and gets overwritten by the next sample
+    auto offset = _getTimeSeriesSampleOffset(_timeSeriesPage, _timeSeriesCount);
+    uint8_t marker = _getTimeSeriesMarker(_timeSeriesCycleId);
+    __ASSERT_DATA(offset, timeSeriesSlotSize);
+#if ARDUINO_EEPROM_WRITE_ERROR_RETRIES
+    for (uint8_t i = 0; i < ARDUINO_EEPROM_WRITE_ERROR_RETRIES; i++)
+#endif
+    {
+        _eepromWrite(offset, data, timeSeriesSampleSize);
+        auto src = data;
+        DataBlockSizeType n = 0;
+        while (n < timeSeriesSampleSize && _eeprom.read(offset + n) == *src++) {
+            n++;
+        }
+        if (n == timeSeriesSampleSize) {
+            _eepromWrite(offset + timeSeriesSampleSize, ConstByteAccessArray(&marker), sizeof(marker));
+            if (_eeprom.read(offset + timeSeriesSampleSize) == marker) {
+                _timeSeriesCount++;
+                return true;
+            }
+        }
+    }
+    _debug_printf_P(PSTR("%04lx: error\n"), (unsigned long)offset);
+    return false;
+}
+
+bool ArduinoEEPROMBase::beginSamples(TimeSeriesIterator_t &iterator) const
+{
+    // the page following the latest page contains the oldest samples
+    iterator.sequence = 0;
+    iterator.cycleId = _addCycleId(_timeSeriesCycleId, 1 - (int32_t)timeSeriesNumPages);
+    iterator.page = (_timeSeriesPage + 1) % timeSeriesNumPages;
+    iterator.remaining = _timeSeriesCycleId ? timeSeriesNumPages : 0;
+    iterator.sample = (iterator.remaining && _isTimeSeriesPage(iterator.page, iterator.cycleId)) ? 0 : timeSeriesSamplesPerPage;
+    return iterator.remaining != 0;
+}
+
+bool ArduinoEEPROMBase::readSample(TimeSeriesIterator_t &iterator, ByteAccessPointer data) const
+{
+    __ASSERT_SET_DATA_TYPE(TIME_SERIES);
+    while (iterator.remaining) {
+        // the samples of a page are valid up to the first invalid sample
+        if (iterator.sample < timeSeriesSamplesPerPage && _isTimeSeriesSample(iterator.page, iterator.sample, iterator.cycleId)) {
+            auto offset = _getTimeSeriesSampleOffset(iterator.page, iterator.sample);
+            __ASSERT_DATA(offset, timeSeriesSampleSize);
+            _eepromRead(offset, data, timeSeriesSampleSize);
+            // the position is counted from the oldest page and does not depend on the cycle id, which wraps
+            // around with ARDUINO_EEPROM_CYCLE_ID_BITS < 32
+            iterator.sequence = ((timeSeriesNumPages - iterator.remaining) * (uint32_t)timeSeriesSamplesPerPage) + iterator.sample;
+            iterator.sample++;
+            return true;
+        }
+        // continue with the next page. pages without a valid header are skipped
+        if (--iterator.remaining) {
+            iterator.page = (iterator.page + 1) % timeSeriesNumPages;
+            iterator.cycleId = _addCycleId(iterator.cycleId, 1);
+            iterator.sample = _isTimeSeriesPage(iterator.page, iterator.cycleId) ? 0 : timeSeriesSamplesPerPage;
+        }
+    }
+    return false;
+}
+
+uint32_t ArduinoEEPROMBase::getNumSamples() const
+{
+    if (_timeSeriesCycleId == 0) {
+        return 0;
+    }
+    uint32_t count = _timeSeriesCount;
+    uint32_t cycleId = _timeSeriesCycleId;
+    EEPROMSizeType page = _timeSeriesPage;
+    for (EEPROMSizeType i = 1; i < timeSeriesNumPages; i++) {
+        cycleId = _addCycleId(cycleId, -1);
+        page = (page ? page : timeSeriesNumPages) - 1;
+        if (_isTimeSeriesPage(page, cycleId)) {
+            count += _getTimeSeriesCount(page, cycleId);
+        }
+    }
+    return count;
+}
+
+void ArduinoEEPROMBase::_readTimeSeries()
+{
+    _timeSeriesPage = 0;
+    _timeSeriesCycleId = 0;
+    _timeSeriesCount = 0;
+    for (EEPROMSizeType page = 0; page < timeSeriesNumPages; page++) {
+        DataBlockHeader_t header;
+        __ASSERT_DATA(_getTimeSeriesPageOffset(page), sizeof(header));
+        _eepromRead(_getTimeSeriesPageOffset(page), ByteAccessArray(&header), sizeof(header));
+        if (_isTimeSeriesPage(page, header.cycleId) && _isNewerCycleId(header.cycleId, _timeSeriesCycleId)) {
+            _timeSeriesPage = page;
+            _timeSeriesCycleId = header.cycleId;
+        }
+    }
+    if (_timeSeriesCycleId) {
+        _timeSeriesCount = _getTimeSeriesCount(_timeSeriesPage, _timeSeriesCycleId);
+    }
+    _debug_printf_P(PSTR("page=%lu, cycleId=%lu, count=%u\n"), (unsigned long)_timeSeriesPage, (unsigned long)_timeSeriesCycleId, _timeSeriesCount);
+}
+
+void ArduinoEEPROMBase::_formatTimeSeries()
+{
+    // empty headers for the first cycle. markers that match the first cycle are cleared when the page is started
+    for (EEPROMSizeType page = 0; page < timeSeriesNumPages; page++) {
+        __ASSERT_DATA(_getTimeSeriesPageOffset(page), sizeof(DataBlockHeader_t));
+        _eepromClear(_getTimeSeriesPageOffset(page), sizeof(DataBlockHeader_t));
+    }
+    _timeSeriesPage = 0;
+    _timeSeriesCycleId = 0;
+    _timeSeriesCount = 0;
+}
+
+bool ArduinoEEPROMBase::_beginTimeSeriesPage(EEPROMSizeType page, uint32_t cycleId)
+{
+    auto offset = _getTimeSeriesPageOffset(page);
+    _debug_printf_P(PSTR("page=%lu, cycleId=%lu\n"), (unsigned long)page, (unsigned long)cycleId);
+
+    // the markers of the previous cycle do not match. a marker of cycleId can be left over if the cycle id has
+    // wrapped around or the page has not been used before
+    uint8_t marker = _getTimeSeriesMarker(cycleId);
+    uint8_t invalid = ~marker;
+    for (uint16_t sample = 0; sample < timeSeriesSamplesPerPage; sample++) {
+        if (_isTimeSeriesSample(page, sample, cycleId)) {
+            // the old header must be invalid before any marker is modified
+            __ASSERT_DATA(offset, sizeof(DataBlockHeader_t));
+            _eepromClear(offset, sizeof(DataBlockHeader_t));
+            auto markerOffset = _getTimeSeriesSampleOffset(page, sample) + timeSeriesSampleSize;
+            _eepromWrite(markerOffset, ConstByteAccessArray(&invalid), sizeof(invalid));
+            if (_isTimeSeriesSample(page, sample, cycleId)) {
+                _debug_printf_P(PSTR("%04lx: error\n"), (unsigned long)markerOffset);
+                return false;
+            }
+        }
+    }
+
+    DataBlockHeader_t header;
+    _setDataBlockHeaderCycleId(header, cycleId);
+    header.crc = _dataBlockHeaderCrc(header);
+    __ASSERT_DATA(offset, sizeof(header));
+    _eepromWrite(offset, ConstByteAccessArray(&header), sizeof(header));
+    return _isTimeSeriesPage(page, cycleId);
+}
+
+bool ArduinoEEPROMBase::_isTimeSeriesPage(EEPROMSizeType page, uint32_t cycleId) const
+{
+    DataBlockHeader_t header;
+    __ASSERT_DATA(_getTimeSeriesPageOffset(page), sizeof(header));
+    _eepromRead(_getTimeSeriesPageOffset(page), ByteAccessArray(&header), sizeof(header));
+    if (header.cycleId == 0 || header.cycleId != cycleId || header.crc != _dataBlockHeaderCrc(header)) {
+        return false;
+    }
+#if ARDUINO_EEPROM_CYCLE_ID_BITS != 32
+    if (header.cycleId > cycleIdMax) {
+        return false;
+    }
+#endif
+#if ARDUINO_EEPROM_HAVE_COMMIT_MARKER
+    if (header.commit != _getCommitMarker(header.cycleId)) {
+        return false;
+    }
+#endif
+    return true;
+}
+
+uint16_t ArduinoEEPROMBase::_getTimeSeriesCount(EEPROMSizeType page, uint32_t cycleId) const
+{
+    uint16_t count = 0;
+    while (count < timeSeriesSamplesPerPage && _isTimeSeriesSample(page, count, cycleId)) {
+        count++;
+    }
+    return count;
+}
+
+bool ArduinoEEPROMBase::_isTimeSeriesSample(EEPROMSizeType page, uint16_t sample, uint32_t cycleId) const
+{
+    auto offset = _getTimeSeriesSampleOffset(page, sample) + timeSeriesSampleSize;
+    __ASSERT_DATA(offset, 1);
+    return _eeprom.read(offset) == _getTimeSeriesMarker(cycleId);
+}
+
+#endif
+
+#if ARDUINO_EEPROM_HAVE_RECORD_STORE
+
+uint8_t ArduinoEEPROMBase::readRecord(uint8_t key, ByteAccessPointer data, uint8_t size) const
+{
+    __ASSERT_SET_DATA_TYPE(RECORDS);
+    DataBlockHeader_t header;
+    RecordInfo_t info;
+    if (key >= recordMaxKeys || _recordOffsets[key] == INVALID_OFFSET || !_readRecordHeader(_recordOffsets[key], header, info)) {
+        return 0;
+    }
+    __ASSERT_DATA(_recordOffsets[key] + recordHeaderSize, min(size, info.length));
+    _eepromRead(_recordOffsets[key] + recordHeaderSize, data, min(size, info.length));
+    return info.length;
+}
+
+bool ArduinoEEPROMBase::writeRecord(uint8_t key, ConstByteAccessPointer data, uint8_t length)
+{
+    __ASSERT_SET_DATA_TYPE(RECORDS);
+    if (key >= recordMaxKeys || length == 0 || length > recordMaxSize) {
+        return false;
+    }
+    auto offset = _allocateRecord(length);
+    if (offset == INVALID_OFFSET) {
+        return false;
+    }
+    return _writeRecord(offset, key, data, length);
+}
+
+void ArduinoEEPROMBase::_readRecords()
+{
+    // the cycle ids of the records in the index
+    uint32_t cycleIds[recordMaxKeys];
+    for (uint8_t i = 0; i < recordMaxKeys; i++) {
+        _recordOffsets[i] = INVALID_OFFSET;
+        cycleIds[i] = 0;
+    }
+    _recordHeadOffset = recordStoreOffset;
+    _recordHeadCycleId = 0;
+
+    for (EEPROMSizeType segment = 0; segment < recordNumSegments; segment++) {
+        EEPROMSizeType offset = recordStoreOffset + (segment * recordSegmentSize);
+        uint32_t cycleId = 0;
+        DataBlockHeader_t header;
+        RecordInfo_t info;
+        // records that follow an interrupted or an overwritten record are ignored
+        while (offset + recordHeaderSize < recordStoreOffset + ((segment + 1) * recordSegmentSize) && _readRecordHeader(offset, header, info)) {
+            if (cycleId && header.cycleId != _addCycleId(cycleId, 1)) {
+                break;
+            }
+            cycleId = header.cycleId;
+            if (_isNewerCycleId(cycleId, cycleIds[info.key])) {
+                cycleIds[info.key] = cycleId;
+                _recordOffsets[info.key] = offset;
+            }
+            offset += recordHeaderSize + info.length;
+            if (_isNewerCycleId(cycleId, _recordHeadCycleId)) {
+                _recordHeadCycleId = cycleId;
+                _recordHeadOffset = offset;
+            }
+        }
+    }
+    _debug_printf_P(PSTR("head=%04lx, cycleId=%lu\n"), (unsigned long)_recordHeadOffset, (unsigned long)_recordHeadCycleId);
+}
+
+void ArduinoEEPROMBase::_formatRecords()
+{
+    // a cycle id of 0 marks the end of the records in a segment. the entire store is cleared since old
+    // records could be mistaken for the continuation of new records otherwise
+    for (EEPROMSizeType pos = 0; pos < recordStoreLength; pos += burstSize) {
+        _eepromClear(recordStoreOffset + pos, min((EEPROMSizeType)(recordStoreLength - pos), (EEPROMSizeType)burstSize));
+    }
+    for (uint8_t i = 0; i < recordMaxKeys; i++) {
+        _recordOffsets[i] = INVALID_OFFSET;
+    }
+    _recordHeadOffset = recordStoreOffset;
+    _recordHeadCycleId = 0;
+}
+
+ArduinoEEPROMBase::EEPROMSizeType ArduinoEEPROMBase::_allocateRecord(uint8_t length)
+{
+    EEPROMSizeType offset = _recordHeadOffset;
+    EEPROMSizeType segment = _recordHeadCycleId ? _getRecordSegment(offset - 1) : 0;
+    for (;;) {
+        // the latest records of the next segment are copied when the current segment is entered. the next segment
+        // does not contain any latest records afterwards and can be overwritten when the current segment is full.
+        // if a copy operation gets interrupted, the remaining records are copied before the next record
+        EEPROMSizeType next = (segment + 1) % recordNumSegments;
+        EEPROMSizeType end = recordStoreOffset + ((segment + 1) * recordSegmentSize);
+        for (uint8_t i = 0; i < recordMaxKeys; i++) {
+            if (_recordOffsets[i] == INVALID_OFFSET || _getRecordSegment(_recordOffsets[i]) != next) {
+                continue;
+            }
+            uint8_t buffer[sizeof(RecordInfo_t) + recordMaxSize];
+            DataBlockHeader_t header;
+            RecordInfo_t info;
+            if (!_readRecordHeader(_recordOffsets[i], header, info)) {
+                // the record has been damaged since begin() was called
+                _recordOffsets[i] = INVALID_OFFSET;
+                continue;
+            }
+            if (offset + recordHeaderSize + info.length > end) {
+                _debug_printf_P(PSTR("segment %lu full\n"), (unsigned long)segment);
+                return INVALID_OFFSET;
+            }
+            __ASSERT_DATA(_recordOffsets[i], sizeof(header) + sizeof(info) + info.length);
+            if (!_readDataBlock(_recordOffsets[i], ByteAccessArray(buffer), sizeof(info) + info.length, header)) {
+                _recordOffsets[i] = INVALID_OFFSET;
+                continue;
+            }
+            _debug_printf_P(PSTR("copy key=%u, src=%04lx, dst=%04lx\n"), i, (unsigned long)_recordOffsets[i], (unsigned long)offset);
+            if (!_writeRecord(offset, i, ConstByteAccessArray(buffer + sizeof(info)), info.length)) {
+                return INVALID_OFFSET;
+            }
+            offset = _recordHeadOffset;
+        }
+        if (offset + recordHeaderSize + length <= end) {
+            return offset;
+        }
+        // continue with the next segment
+        segment = next;
+        offset = recordStoreOffset + (segment * recordSegmentSize);
+    }
+}
+
+bool ArduinoEEPROMBase::_writeRecord(EEPROMSizeType offset, uint8_t key, ConstByteAccessPointer data, uint8_t length)
+{
+    uint8_t buffer[sizeof(RecordInfo_t) + recordMaxSize];
+    auto &info = *reinterpret_cast<RecordInfo_t *>(buffer);
+    info.key = key;
+    info.length = length;
+    for (uint8_t i = 0; i < length; i++) {
+        buffer[sizeof(info) + i] = *data++;
+    }
+    uint32_t cycleId = _addCycleId(_recordHeadCycleId, 1);
+    __ASSERT_DATA(offset, sizeof(DataBlockHeader_t) + sizeof(info) + length);
+    if (!_writeDataBlock(offset, cycleId, ConstByteAccessArray(buffer), sizeof(info) + length)) {
+        return false;
+    }
+    _recordOffsets[key] = offset;
+    _recordHeadOffset = offset + recordHeaderSize + length;
+    _recordHeadCycleId = cycleId;
+    return true;
+}
+
+bool ArduinoEEPROMBase::_readRecordHeader(EEPROMSizeType offset, DataBlockHeader_t &header, RecordInfo_t &info) const
+{
+    __ASSERT_DATA(offset, sizeof(header) + sizeof(info));
+    _eepromRead(_eepromRead(offset, ByteAccessArray(&header), sizeof(header)), ByteAccessArray(&info), sizeof(info));
+    if (header.cycleId == 0 || info.key >= recordMaxKeys || info.length == 0 || info.length > recordMaxSize) {
+        return false;
+    }
+#if ARDUINO_EEPROM_CYCLE_ID_BITS != 32
+    if (header.cycleId > cycleIdMax) {
+        return false;
+    }
+#endif
+#if ARDUINO_EEPROM_HAVE_COMMIT_MARKER
+    if (header.commit != _getCommitMarker(header.cycleId)) {
+        return false;
+    }
+#endif
+    // records do not cross the segment boundaries
+    if (_getRecordSegment(offset) != _getRecordSegment(offset + recordHeaderSize + info.length - 1)) {
+        return false;
+    }
+    return _validateEepromDataBlockCrc(offset, sizeof(info) + info.length, header);
+}
+
+#endif
+
+#if ARDUINO_EEPROM_HAVE_SCRUB
+
+bool ArduinoEEPROMBase::scrub(EEPROMSizeType budget)
+{
+    if (_scrub.cursor == 0) {
+        // new pass
+        _scrub.staticDataRepaired = 0;
+        _scrub.staticDataErrors = 0;
+        _scrub.wearLevelErrors = 0;
+        _scrub.lastErrorOffset = INVALID_OFFSET;
+        auto count = _scrubStaticData();
+        budget = (budget > count) ? budget - count : 0;
+        _scrub.cursor++;
+    }
+
+    __ASSERT_SET_DATA_TYPE(WEAR_LEVEL_DATA);
+    DataBlockHeader_t header;
+    while (budget--) {
+        auto offset = _getWearLevelBlockOffset(_scrub.cursor - 1);
+        if (!_validateEepromDataBlockCrc(offset, wearLevelPayloadSize, header) && !_isEmptyBlock(offset, header.cycleId)) {
+            _debug_printf_P(PSTR("%04lx: error, cycleId=%lu\n"), (unsigned long)offset, (unsigned long)header.cycleId);
+            _scrub.wearLevelErrors++;
+            _scrub.lastErrorOffset = offset;
+        }
+        if (_scrub.cursor++ == wearLevelNumBlocks) {
+            _debug_printf_P(PSTR("pass=%lu, repaired=%02x, errors=%02x/%lu\n"), (unsigned long)_scrub.passes, _scrub.staticDataRepaired, _scrub.staticDataErrors, (unsigned long)_scrub.wearLevelErrors);
+            _scrub.cursor = 0;
+            _scrub.passes++;
+            return true;
+        }
+    }
+    return false;
+}
+
+const ArduinoEEPROMBase::ScrubState_t &ArduinoEEPROMBase::getScrubState() const
+{
+    return _scrub;
+}
+
+uint8_t ArduinoEEPROMBase::_scrubStaticData()
+{
+    __ASSERT_SET_DATA_TYPE(STATIC_DATA);
+    uint8_t count = staticDataCopies;
+    uint8_t copiesBitset = ~0;
+    _getStaticDataCycleIdAndBitset(copiesBitset, nullptr);
+    if (!copiesBitset) {
+        // no valid copy
+        _scrub.staticDataErrors = _BV(staticDataCopies) - 1;
+        return count;
+    }
+
+    uint8_t source = 0;
+    while (!(copiesBitset & _BV(source))) {
+        source++;
+    }
+    for (uint8_t i = 0; i < staticDataCopies; i++) {
+        if (copiesBitset & _BV(i)) {
+            continue;
+        }
+        count++;
+        if (_copyDataBlock(_getStaticDataOffset(i), _getStaticDataOffset(source), staticDataTypeSize)) {
+            _scrub.staticDataRepaired |= _BV(i);
+        }
+        else {
+            _scrub.staticDataErrors |= _BV(i);
+        }
+    }
+    return count;
+}
+
+bool ArduinoEEPROMBase::_copyDataBlock(EEPROMSizeType dst, EEPROMSizeType src, DataBlockSizeType size) const
+{
+    _debug_printf_P(PSTR("dst=%04lx, src=%04lx\n"), (unsigned long)dst, (unsigned long)src);
+
+#if ARDUINO_EEPROM_WRITE_ERROR_RETRIES
+    for (uint8_t i = 0; i < ARDUINO_EEPROM_WRITE_ERROR_RETRIES; i++)
+#endif
+    {
+        uint8_t buffer[burstSize];
+        EEPROMSizeType srcOffset = src + sizeof(DataBlockHeader_t);
+        EEPROMSizeType dstOffset = dst + sizeof(DataBlockHeader_t);
+        DataBlockSizeType remaining = size;
+        while (remaining) {
+            DataBlockSizeType len = min(remaining, (DataBlockSizeType)burstSize);
+            srcOffset = _eepromRead(srcOffset, ByteAccessArray(buffer), len);
+            dstOffset = _eepromWrite(dstOffset, ConstByteAccessArray(buffer), len);
+            remaining -= len;
+        }
+
+        DataBlockHeader_t header;
+        __ASSERT_DATA(src, sizeof(header));
+        _eepromRead(src, ByteAccessArray(&header), sizeof(header));
+        __ASSERT_DATA(dst, sizeof(header));
+        _eepromWrite(dst, ConstByteAccessArray(&header), sizeof(header));
+
+        if (_validateEepromDataBlockCrc(dst, size, header)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+#endif
+
+#if ARDUINO_EEPROM_HAVE_DUMP
+
+void ArduinoEEPROMBase::dumpOffsets(Print &output) const
+{
+    Serial_printf_P(
+        PSTR(
+            "page size:        %lu\n"
+            "start:            %lu:%lu\n"
+            "static:           %lu:%lu (copies %u, size %lu/%lu/%lu)\n"
+            "end:              %lu\n"
+            "wear level:       %lu:%lu (blocks %lu, cycles %lu, copies %u, size %lu/%lu/%lu)\n"
+            "end:              %lu\n"
+            "unused:           %lu:%lu\n"
+            "eeprom end:       %lu\n"
+        ),
+        (unsigned long)pageSize,
+        (unsigned long)startOffset, (unsigned long)eepromLength,
+        (unsigned long)staticDataOffset, (unsigned long)staticDataLength,
+        staticDataCopies, (unsigned long)staticDataTypeSize, (unsigned long)staticDataBlockSize, (unsigned long)ARDUINO_EEPROM_ALIGN_LEN(staticDataBlockSize),
+        (unsigned long)(staticDataOffset + staticDataLength - 1),
+        (unsigned long)wearLevelDataOffset, (unsigned long)wearLevelDataLength,
+        (unsigned long)wearLevelNumBlocks, (unsigned long)wearLevelNumCycles, wearLevelDataCopies, (unsigned long)wearLevelDataTypeSize, (unsigned long)wearLevelBlockSize, (unsigned long)ARDUINO_EEPROM_ALIGN_LEN(wearLevelBlockSize),
+        (unsigned long)(wearLevelDataOffset + wearLevelDataLength - 1),
+        (unsigned long)(wearLevelDataOffset + wearLevelDataLength),
+        (unsigned long)eepromUnusedBytes,
+        (unsigned long)(startOffset + eepromLength - 1)
+    );
+#if ARDUINO_EEPROM_HAVE_CHECKPOINT
+    Serial_printf_P(PSTR("checkpoint:       %lu:%lu (slots %u, interval %u)\n"), (unsigned long)checkpointOffset, (unsigned long)checkpointLength, checkpointSlots, ARDUINO_EEPROM_CHECKPOINT_INTERVAL);
+#endif
+#if ARDUINO_EEPROM_HAVE_EPOCH
+    Serial_printf_P(PSTR("epoch:            %lu:%lu (slots %u, cycle id %lu)\n"), (unsigned long)epochOffset, (unsigned long)epochLength, epochSlots, (unsigned long)_epochCycleId);
+#endif
+#if ARDUINO_EEPROM_HAVE_BAD_BLOCKS
+    Serial_printf_P(PSTR("bad blocks:       %lu:%lu (copies %u, marked %lu)\n"), (unsigned long)badBlocksOffset, (unsigned long)badBlocksLength, badBlocksCopies, (unsigned long)getNumBadBlocks());
+#endif
+#if ARDUINO_EEPROM_HAVE_COUNTER
+    Serial_printf_P(PSTR("counter:          %lu:%lu (slots %u, log %u)\n"), (unsigned long)counterOffset, (unsigned long)counterLength, counterSlots, (unsigned)counterLogSize);
+#endif
+#if ARDUINO_EEPROM_HAVE_RECORD_STORE
+    Serial_printf_P(PSTR("records:          %lu:%lu (segments %lu, size %lu, keys %u, max. size %u)\n"), (unsigned long)recordStoreOffset, (unsigned long)recordStoreLength, (unsigned long)recordNumSegments, (unsigned long)recordSegmentSize, recordMaxKeys, recordMaxSize);
+#endif
+#if ARDUINO_EEPROM_HAVE_TIME_SERIES
+    Serial_printf_P(PSTR("time series:      %lu:%lu (pages %lu, size %lu, samples %u, sample size %u)\n"), (unsigned long)timeSeriesOffset, (unsigned long)timeSeriesLength, (unsigned long)timeSeriesNumPages, (unsigned long)timeSeriesPageSize, timeSeriesSamplesPerPage, (unsigned)timeSeriesSampleSize);
+#endif
+}
+
+void ArduinoEEPROMBase::dump(Print &output, DataTypeEnum type) const
+{
+    uint8_t copies = ~0;
+    uint8_t valid = 0;
+    uint32_t cycleId = _getStaticDataCycleIdAndBitset(copies);
+    char buf[staticDataCopies + 1];
+    uint8_t i = 0;
+    for (; i < staticDataCopies; i++) {
+        if (copies & _BV(i)) {
+            buf[i] = '1';
+            valid++;
+        }
+        else {
+            buf[i] = 'x';
+        }
+    }
+    buf[i] = 0;
+
+    dumpOffsets(output);
+
+    Serial_printf_P(PSTR("Static data: %u / %u (%s)\n"), valid, staticDataCopies, buf);
+
+    auto offset = _getWearLevelHeadOffset(cycleId);
+    Serial_printf_P(PSTR("Wear level: offset = %lu, cycle id = %lu\n"),
+        (unsigned long)offset,
+        (unsigned long)cycleId
+    );
+    Serial_printf_P(PSTR("_debugCycleCount=%lu\n"), (unsigned long)_debugCycleCount);
+    //Serial_printf_P(PSTR("size=%u,data=%u,overhead=%u,redundant=%u,unused=%u\n"),
+    //    eepromLength,
+    //    staticDataTypeSize + (wearLevelDataTypeSize * wearLevelNumCycles),
+    //    (sizeof(DataBlockHeader_t) * (staticDataCopies + wearLevelNumBlocks)) + (staticDataOffset - startOffset),
+    //    (staticDataTypeSize * (staticDataCopies - 1)) + (wearLevelDataTypeSize * (wearLevelDataCopies - 1) * (wearLevelNumBlocks / wearLevelDataCopies)),
+    //    eepromUnusedBytes
+    //);
+
+    if ((uint8_t)type & (uint8_t)DataTypeEnum::STATIC_DATA) {
+        __ASSERT_SET_DATA_TYPE(STATIC_DATA);
+        Serial.println(F("Ofs   CRC  CycleId  Status"));
+        EEPROMSizeType offset = staticDataOffset;
+        DataBlockHeader_t header;
+        for (uint8_t i = 0; i < staticDataCopies; i++) {
+            auto result = _validateEepromDataBlockCrc(offset, staticDataTypeSize, header);
+            Serial_printf_P(PSTR("%04lx: %04x %08lx %s\n"), (unsigned long)offset, header.crc, (unsigned long)header.cycleId, header.cycleId ? (result ? "GOOD" : "BAD") : "EMPTY");
+            offset += ARDUINO_EEPROM_ALIGN_LEN(staticDataBlockSize);
+        }
+    }
+
+    if ((uint8_t)type & (uint8_t)DataTypeEnum::WEAR_LEVEL_DATA) {
+        __ASSERT_SET_DATA_TYPE(WEAR_LEVEL_DATA);
+        Serial.println(F("Ofs Cycle CRC  CycleId  Status"));
+
+        EEPROMSizeType offset = wearLevelDataOffset;
+        DataBlockHeader_t header;
+        EEPROMSizeType n = 1;
+        while (offset <= wearLevelDataLastStartOffset) {
+            Serial_printf_P(PSTR("%lu/%lu "), (unsigned long)n++, (unsigned long)wearLevelNumBlocks);
+            auto result = _validateEepromDataBlockCrc(offset, wearLevelPayloadSize, header);
+            auto cycle = (unsigned)(((header.cycleId - 1) / wearLevelDataCopies) % (wearLevelNumCycles));
+            Serial_printf_P(PSTR("ofs=%04lx "), (unsigned long)offset);
+            if (!result) {
+                Serial_printf_P(PSTR("cycle=%u cycleId=%lu invalid data, error\n"), cycle, (unsigned long)(header.cycleId));
+            }
+            else {
+                Serial_printf_P(PSTR("cycle=%u cycleId=%lu %s\n"), cycle, (unsigned long)header.cycleId, !_isEmptyBlock(offset, header.cycleId) ? (result ? "GOOD" : "BAD") : "EMPTY");
+            }
+            offset += ARDUINO_EEPROM_ALIGN_LEN(wearLevelBlockSize);
+        }
+    }
+
+#if ARDUINO_EEPROM_HAVE_COUNTER
+    if ((uint8_t)type & (uint8_t)DataTypeEnum::COUNTER) {
+        Serial_printf_P(PSTR("Counter: value = %lu, checkpoint = %lu, slot = %u, position = %u/%u\n"),
+            (unsigned long)readCounter(), (unsigned long)_counterValue, _counterSlot, _counterPosition, (unsigned)counterLogSize
+        );
+    }
+#endif
+
+#if ARDUINO_EEPROM_HAVE_RECORD_STORE
+    if ((uint8_t)type & (uint8_t)DataTypeEnum::RECORDS) {
+        __ASSERT_SET_DATA_TYPE(RECORDS);
+        Serial_printf_P(PSTR("Records: head = %04lx, cycle id = %lu\n"), (unsigned long)_recordHeadOffset, (unsigned long)_recordHeadCycleId);
+        Serial.println(F("Key Ofs  CycleId  Length"));
+        for (uint8_t i = 0; i < recordMaxKeys; i++) {
+            DataBlockHeader_t header;
+            RecordInfo_t info;
+            if (_recordOffsets[i] != INVALID_OFFSET && _readRecordHeader(_recordOffsets[i], header, info)) {
+                Serial_printf_P(PSTR("%3u %04lx %08lx %u\n"), i, (unsigned long)_recordOffsets[i], (unsigned long)header.cycleId, info.length);
+            }
+        }
+    }
+#endif
+
+#if ARDUINO_EEPROM_HAVE_TIME_SERIES
+    if ((uint8_t)type & (uint8_t)DataTypeEnum::TIME_SERIES) {
+        __ASSERT_SET_DATA_TYPE(TIME_SERIES);
+        Serial_printf_P(PSTR("Time series: page = %lu, cycle id = %lu, samples = %u/%u, total = %lu\n"),
+            (unsigned long)_timeSeriesPage, (unsigned long)_timeSeriesCycleId, _timeSeriesCount, timeSeriesSamplesPerPage, (unsigned long)getNumSamples()
+        );
+    }
+#endif
+}
+
+void ArduinoEEPROMBase::dumpBasicInfo(Print &output, const BasicInfo_t &info) const
+{
+    Serial_printf_P(PSTR("valid=%u/%u, write cyles=%lu, size=%lu\n"), info.staticData.valid, info.staticData.copies, (unsigned long)info.staticData.writeCycles, (unsigned long)info.staticData.size);
+    Serial_printf_P(PSTR("valid=%u, write cycles=%lu, cycle id=%lu, size=%lu\n"), info.wearLevelData.valid, (unsigned long)info.wearLevelData.writeCycles, (unsigned long)info.wearLevelData.cycleId, (unsigned long)info.wearLevelData.size);
+}
+
+#endif
+
+void ArduinoEEPROMBase::_eraseAndInitialize(EEPROMSizeType offset, DataBlockSizeType size, EEPROMSizeType numBlocks) const
+{
+    DataBlockHeader_t header;
+
+    _setDataBlockHeaderCycleId(header, 0);
+    header.crc = _dataBlockHeaderCrc(header);
+    for (DataBlockSizeType i = 0; i < size; i++) {
+        header.crc = BlockCRC::update(header.crc, (uint8_t)0);
+    }
+#if ARDUINO_EEPROM_PAGE_SIZE > 1
+    // extra space till next page
+    uint8_t extra = ARDUINO_EEPROM_ALIGN_LEN(size + sizeof(header)) - (size + sizeof(header));
+#endif
+    for (EEPROMSizeType i = 0; i < numBlocks; i++) {
+        __ASSERT_DATA(offset, sizeof(header));
+        offset = _eepromWrite(offset, ConstByteAccessArray(&header), sizeof(header));
+        __ASSERT_DATA(offset, size);
+        offset = _eepromClear(offset, size);
+#if ARDUINO_EEPROM_PAGE_SIZE > 1
+        offset += extra;
+#endif
+    }
+}
+
+uint32_t ArduinoEEPROMBase::_getStaticDataCycleIdAndBitset(uint8_t &copiesBitset, uint32_t *cycleIds) const
+{
+    uint32_t maxCycleId = 0;
+    uint32_t cycleIdsTmp[staticDataCopies];
+    DataBlockHeader_t header;
+
+    __ASSERT_SET_DATA_TYPE(STATIC_DATA);
+
+    if (!cycleIds) {
+        cycleIds = cycleIdsTmp;
+    }
+
+    memset(cycleIds, 0xff, sizeof(cycleIdsTmp));
+
+    for (uint8_t i = 0; i < staticDataCopies; i++) {
+        if (copiesBitset & _BV(i)) {
+            if (_validateEepromDataBlockCrc(_getStaticDataOffset(i), staticDataTypeSize, header)) {
+                cycleIds[i] = header.cycleId;
+                if (_isNewerCycleId(header.cycleId, maxCycleId)) {
+                    maxCycleId = header.cycleId;
+                }
+            }
+        }
+    }
+
+    copiesBitset = 0;
+    for (uint8_t i = 0; i < staticDataCopies; i++) {
+        if (maxCycleId == cycleIds[i]) {
+            copiesBitset |= _BV(i);
+        }
+    }
+    return maxCycleId;
+}
+
+uint32_t ArduinoEEPROMBase::_getStaticDataCycleId() const
+{
+    uint8_t copiesBitset = ~0;
+    auto cycleId = _getStaticDataCycleIdAndBitset(copiesBitset, nullptr);
+    if (copiesBitset) {
+        return cycleId;
+    }
+    return ~0;
+}
+
+#if !_MSC_VER || !DEBUG
 ArduinoEEPROMBase::EEPROMSizeType ArduinoEEPROMBase::_getStaticDataOffset(uint8_t index) const
 {
     return staticDataOffset + (index * ARDUINO_EEPROM_ALIGN_LEN(staticDataBlockSize));
@@ -447,33 +1755,563 @@ ArduinoEEPROMBase::EEPROMSizeType ArduinoEEPROMBase::_getStaticDataOffset(uint8_
 
 ArduinoEEPROMBase::EEPROMSizeType ArduinoEEPROMBase::_getWearLevelOffset(uint32_t &cycleId, uint32_t maxCycleId) const
 {
-    auto lastOffset = INVALID_OFFSET;
     DataBlockHeader_t header;
     __ASSERT_SET_DATA_TYPE(WEAR_LEVEL_DATA);
     __ASSERT(cycleId == 0 || maxCycleId != ~0);
 
-    EEPROMSizeType offset = wearLevelDataOffset;
+    // only the cycle ids are read to rank up to ARDUINO_EEPROM_WEAR_LEVEL_MAX_READ_COPIES candidates with a single
+    // scan and their CRC is validated afterwards, starting with the highest cycle id
+    WearLevelBlock_t blocks[ARDUINO_EEPROM_WEAR_LEVEL_MAX_READ_COPIES];
+    auto count = _getWearLevelOffsets(blocks, ARDUINO_EEPROM_WEAR_LEVEL_MAX_READ_COPIES, maxCycleId);
+    for (uint8_t i = 0; i < count; i++) {
+        if (_isNewerCycleId(cycleId, blocks[i].cycleId)) {
+            return INVALID_OFFSET;
+        }
+        if (_validateEepromDataBlockCrc(blocks[i].offset, wearLevelPayloadSize, header)) {
+            cycleId = blocks[i].cycleId;
+            return blocks[i].offset;
+        }
+        _debug_printf_P(PSTR("%04lx: error\n"), (unsigned long)blocks[i].offset);
+    }
+
+    // if the list was full, the remaining blocks are validated with a second scan to keep the number of blocks
+    // read linear. otherwise only blocks with cycle id 0 are left. the scan starts with the last block, since
+    // blocks with the same cycle id are ranked by offset
+    bool all = (count == ARDUINO_EEPROM_WEAR_LEVEL_MAX_READ_COPIES);
+    auto lastOffset = INVALID_OFFSET;
+    uint32_t lastCycleId = 0;
+    for (EEPROMSizeType index = wearLevelNumBlocks; index-- > 0;) {
+        auto offset = _getWearLevelBlockOffset(index);
+        auto id = _readCycleId(offset);
+        if (id == 0) {
+            if (cycleId != 0) {
+                continue;
+            }
+        }
+        else if (!all || _isNewerCycleId(cycleId, id) || _isNewerCycleId(id, blocks[count - 1].cycleId) || (id == blocks[count - 1].cycleId && offset >= blocks[count - 1].offset)) {
+            continue;
+        }
+        if (lastOffset != INVALID_OFFSET && !_isNewerCycleId(id, lastCycleId)) {
+            continue;
+        }
+#if ARDUINO_EEPROM_HAVE_EPOCH
+        // empty blocks do not have a valid CRC
+        if (id != 0 && !_validateEepromDataBlockCrc(offset, wearLevelPayloadSize, header)) {
+            continue;
+        }
+#else
+        if (!_validateEepromDataBlockCrc(offset, wearLevelPayloadSize, header)) {
+            continue;
+        }
+#endif
+        lastOffset = offset;
+        lastCycleId = id;
+    }
+    if (lastOffset != INVALID_OFFSET) {
+        cycleId = lastCycleId;
+#if ARDUINO_EEPROM_HAVE_EPOCH
+        if (lastCycleId == 0) {
+            // only empty blocks are left, the next block written follows the last one
+            cycleId = _epochCycleId;
+        }
+#endif
+    }
+    return lastOffset;
+}
 
+uint8_t ArduinoEEPROMBase::_getWearLevelOffsets(WearLevelBlock_t *blocks, uint8_t maxCount, uint32_t maxCycleId) const
+{
+    __ASSERT_SET_DATA_TYPE(WEAR_LEVEL_DATA);
+    uint8_t count = 0;
+    EEPROMSizeType offset = wearLevelDataOffset;
     while (offset <= wearLevelDataLastStartOffset) {
-        __ASSERT_DATA(offset, sizeof(header));
-        _eepromRead(offset, ByteAccessArray(&header), sizeof(header));
-        if (header.cycleId >= cycleId && header.cycleId < maxCycleId) {
-            if (_validateEepromDataBlockCrc(offset, wearLevelDataTypeSize, header)) {
-                lastOffset = offset;
-                cycleId = max(cycleId, header.cycleId);
+        auto cycleId = _readCycleId(offset);
+        if (cycleId != 0 && _isNewerCycleId(maxCycleId, cycleId)) {
+            // insert sorted, the block with the lowest cycle id is dropped if the list is full
+            uint8_t i = count;
+            while (i > 0 && !_isNewerCycleId(blocks[i - 1].cycleId, cycleId)) {
+                if (i < maxCount) {
+                    blocks[i] = blocks[i - 1];
+                }
+                i--;
+            }
+            if (i < maxCount) {
+                blocks[i].offset = offset;
+                blocks[i].cycleId = cycleId;
+                if (count < maxCount) {
+                    count++;
+                }
+            }
+        }
+        offset += ARDUINO_EEPROM_ALIGN_LEN(wearLevelBlockSize);
+    }
+    return count;
+}
+
+ArduinoEEPROMBase::EEPROMSizeType ArduinoEEPROMBase::_getWearLevelHeadOffset(uint32_t &cycleId) const
+{
+    if (_wearLevelHeadOffset != INVALID_OFFSET) {
+        cycleId = _wearLevelHeadCycleId;
+        return _wearLevelHeadOffset;
+    }
+    EEPROMSizeType offset;
+#if ARDUINO_EEPROM_HAVE_CHECKPOINT
+    offset = _findWearLevelHeadOffsetFromCheckpoint(cycleId);
+    if (offset != INVALID_OFFSET) {
+        return offset;
+    }
+    _debug_printf_P(PSTR("checkpoint invalid\n"));
+#endif
+    offset = _findWearLevelHeadOffset(cycleId);
+    if (offset != INVALID_OFFSET) {
+        return offset;
+    }
+    _debug_printf_P(PSTR("binary search failed, scanning all blocks\n"));
+    cycleId = 0;
+    return _getWearLevelOffset(cycleId);
+}
+
+ArduinoEEPROMBase::EEPROMSizeType ArduinoEEPROMBase::_findWearLevelHeadOffset(uint32_t &cycleId) const
+{
+    __ASSERT_SET_DATA_TYPE(WEAR_LEVEL_DATA);
+    // the cycle id of the first block that is not marked as bad minus its index
+    EEPROMSizeType first = 0;
+    while (_isBadBlock(first)) {
+        if (++first == wearLevelNumBlocks) {
+            return INVALID_OFFSET;
+        }
+    }
+    auto firstCycleId = _readCycleId(_getWearLevelBlockOffset(first));
+    if (firstCycleId) {
+        firstCycleId = _addCycleId(firstCycleId, -(int32_t)first);
+    }
+
+    // index of the latest block
+    EEPROMSizeType index;
+    if (firstCycleId == 0) {
+        // nothing has been written since the area was initialized, every block is empty and the next block
+        // written is the first one
+        index = wearLevelNumBlocks - 1;
+        cycleId = _epochCycleId;
+    }
+    else {
+        EEPROMSizeType low = first;                     // cycle id matches
+        EEPROMSizeType high = wearLevelNumBlocks;       // first index that does not match
+        while (high - low > 1) {
+            EEPROMSizeType mid = low + ((high - low) / 2);
+            EEPROMSizeType distance = mid;
+            if (_isWearLevelSequence(0, firstCycleId, distance, high)) {
+                low = distance;
             }
             else {
-                _debug_printf_P(PSTR("%04x: error\n"), offset);
+                high = mid;
             }
         }
+        index = low;
+        cycleId = _addCycleId(firstCycleId, index);
+    }
+    return _validateWearLevelHeadOffset(index, cycleId);
+}
+
+ArduinoEEPROMBase::EEPROMSizeType ArduinoEEPROMBase::_validateWearLevelHeadOffset(EEPROMSizeType index, uint32_t cycleId) const
+{
+    // the blocks following the latest block must contain data from the previous cycle or must be empty
+    // with less than 32 bit, cycle ids that have wrapped around are lower than the number of blocks and empty
+    // blocks are accepted as well
+    for (EEPROMSizeType i = 1; i <= 2 && i < wearLevelNumBlocks; i++) {
+        uint32_t expected = _addCycleId(cycleId, (int32_t)i - (int32_t)wearLevelNumBlocks);
+        EEPROMSizeType next = index + i;
+        if (next >= wearLevelNumBlocks) {
+            next -= wearLevelNumBlocks;
+        }
+        if (_isBadBlock(next)) {
+            continue;
+        }
+        auto id = _readCycleId(_getWearLevelBlockOffset(next));
+        if (id != expected && !(id == 0 && cycleId - _epochCycleId + i <= wearLevelNumBlocks)) {
+            _debug_printf_P(PSTR("index=%lu, cycleId=%lu, next=%lu, id=%lu\n"), (unsigned long)index, (unsigned long)cycleId, (unsigned long)next, (unsigned long)id);
+            return INVALID_OFFSET;
+        }
+    }
+
+    auto offset = _getWearLevelBlockOffset(index);
+#if ARDUINO_EEPROM_HAVE_EPOCH
+    if (cycleId == _epochCycleId) {
+        // the area is empty after a format, the block does not contain valid data
+        return (_readCycleId(offset) == 0) ? offset : INVALID_OFFSET;
+    }
+#endif
+    DataBlockHeader_t header;
+    if (!_validateEepromDataBlockCrc(offset, wearLevelPayloadSize, header) || header.cycleId != cycleId) {
+        _debug_printf_P(PSTR("%04lx: error\n"), (unsigned long)offset);
+        return INVALID_OFFSET;
+    }
+    return offset;
+}
+
+#if ARDUINO_EEPROM_HAVE_CHECKPOINT
+
+ArduinoEEPROMBase::EEPROMSizeType ArduinoEEPROMBase::_findWearLevelHeadOffsetFromCheckpoint(uint32_t &cycleId) const
+{
+    Checkpoint_t checkpoint;
+    __ASSERT_SET_DATA_TYPE(CHECKPOINT);
+    if (_readCheckpoint(checkpoint) == INVALID_CHECKPOINT) {
+        return INVALID_OFFSET;
+    }
+    __ASSERT_SET_DATA_TYPE(WEAR_LEVEL_DATA);
+
+    // the block of the checkpoint contains the same cycle id or has been overwritten in later cycles
+    auto firstCycleId = _readCycleId(checkpoint.offset);
+    if (_isBadBlock(_getWearLevelBlockIndex(checkpoint.offset)) || firstCycleId == (uint32_t)~0 || _isNewerCycleId(checkpoint.cycleId, firstCycleId) || (_getCycleIdDistance(firstCycleId, checkpoint.cycleId) % wearLevelNumBlocks) != 0) {
+        _debug_printf_P(PSTR("%04lx: checkpoint cycleId=%lu, cycleId=%lu\n"), (unsigned long)checkpoint.offset, (unsigned long)checkpoint.cycleId, (unsigned long)firstCycleId);
+        return INVALID_OFFSET;
+    }
+
+    EEPROMSizeType first = (checkpoint.offset - wearLevelDataOffset) / ARDUINO_EEPROM_ALIGN_LEN(wearLevelBlockSize);
+    EEPROMSizeType low = 0;                             // distance of the last block that matches
+    EEPROMSizeType high = 1;                            // distance of the first block that does not match
+    for (;;) {
+        EEPROMSizeType distance = high;
+        if (!_isWearLevelSequence(first, firstCycleId, distance, wearLevelNumBlocks)) {
+            break;
+        }
+        low = high = distance;
+        if (high >= wearLevelNumBlocks - high) {
+            high = wearLevelNumBlocks;
+            break;
+        }
+        high *= 2;
+    }
+    while (high - low > 1) {
+        EEPROMSizeType mid = low + ((high - low) / 2);
+        EEPROMSizeType distance = mid;
+        if (_isWearLevelSequence(first, firstCycleId, distance, high)) {
+            low = distance;
+        }
+        else {
+            high = mid;
+        }
+    }
+
+    EEPROMSizeType index = first + low;
+    if (index >= wearLevelNumBlocks) {
+        index -= wearLevelNumBlocks;
+    }
+    cycleId = _addCycleId(firstCycleId, low);
+    return _validateWearLevelHeadOffset(index, cycleId);
+}
+
+uint8_t ArduinoEEPROMBase::_readCheckpoint(Checkpoint_t &checkpoint) const
+{
+    uint8_t result = INVALID_CHECKPOINT;
+    for (uint8_t i = 0; i < checkpointSlots; i++) {
+        Checkpoint_t tmp;
+        _eepromRead(_getCheckpointOffset(i), ByteAccessArray(&tmp), sizeof(tmp));
+        if (tmp.crc != _checkpointCrc(tmp) || tmp.cycleId <= _epochCycleId || tmp.cycleId > cycleIdMax || tmp.offset < wearLevelDataOffset || tmp.offset > wearLevelDataLastStartOffset ||
+            ((tmp.offset - wearLevelDataOffset) % ARDUINO_EEPROM_ALIGN_LEN(wearLevelBlockSize)) != 0) {
+            continue;
+        }
+        if (result == INVALID_CHECKPOINT || _isNewerCycleId(tmp.cycleId, checkpoint.cycleId)) {
+            checkpoint = tmp;
+            result = i;
+        }
+    }
+    _debug_printf_P(PSTR("slot=%u, offset=%lu, cycleId=%lu\n"), result, (unsigned long)checkpoint.offset, (unsigned long)checkpoint.cycleId);
+    return result;
+}
+
+bool ArduinoEEPROMBase::_writeCheckpoint(EEPROMSizeType offset, uint32_t cycleId) const
+{
+    Checkpoint_t checkpoint;
+    auto slot = _readCheckpoint(checkpoint);
+    if (slot != INVALID_CHECKPOINT && checkpoint.offset == offset && checkpoint.cycleId == cycleId) {
+        return true;
+    }
+    slot = (slot == 0) ? 1 : 0;
+    checkpoint.cycleId = cycleId;
+    checkpoint.offset = offset;
+    checkpoint.crc = _checkpointCrc(checkpoint);
+
+    _debug_printf_P(PSTR("slot=%u, offset=%lu, cycleId=%lu\n"), slot, (unsigned long)offset, (unsigned long)cycleId);
+
+    auto slotOffset = _getCheckpointOffset(slot);
+    _eepromWrite(slotOffset, ConstByteAccessArray(&checkpoint), sizeof(checkpoint));
+    Checkpoint_t tmp;
+    _eepromRead(slotOffset, ByteAccessArray(&tmp), sizeof(tmp));
+    return memcmp(&tmp, &checkpoint, sizeof(tmp)) == 0;
+}
+
+uint16_t ArduinoEEPROMBase::_checkpointCrc(const Checkpoint_t &checkpoint) const
+{
+    return CRC::update((CRCType)~0, &checkpoint.cycleId, sizeof(checkpoint) - sizeof(checkpoint.crc));
+}
+
+ArduinoEEPROMBase::EEPROMSizeType ArduinoEEPROMBase::_getCheckpointOffset(uint8_t slot) const
+{
+    return checkpointOffset + (slot * ARDUINO_EEPROM_ALIGN_LEN(sizeof(Checkpoint_t)));
+}
+
+#endif
+
+#if ARDUINO_EEPROM_HAVE_EPOCH
+
+void ArduinoEEPROMBase::_formatWearLevelData()
+{
+    __ASSERT_SET_DATA_TYPE(EPOCH);
+    _readEpoch();
+
+    // blocks that are not erased and have a higher cycle id than the epoch contain data
+    __ASSERT_SET_DATA_TYPE(WEAR_LEVEL_DATA);
+    uint32_t maxCycleId = _epochCycleId;
+    EEPROMSizeType offset = wearLevelDataOffset;
+    while (offset <= wearLevelDataLastStartOffset) {
+        uint32_t cycleId;
+        __ASSERT_DATA(offset + sizeof(BlockCRCType), sizeof(cycleId));
+        _eepromRead(offset + sizeof(BlockCRCType), ByteAccessArray(&cycleId), sizeof(cycleId));
+        if (cycleId != (uint32_t)~0 && cycleId > maxCycleId) {
+            maxCycleId = cycleId;
+        }
         offset += ARDUINO_EEPROM_ALIGN_LEN(wearLevelBlockSize);
     }
-    return lastOffset;
+
+    __ASSERT_SET_DATA_TYPE(EPOCH);
+    if (maxCycleId < ARDUINO_EEPROM_EPOCH_MAX_CYCLE_ID && _writeEpoch(maxCycleId)) {
+        return;
+    }
+
+    // every block has cycle id 0 afterwards and is empty for any epoch
+    _debug_printf_P(PSTR("resetting cycle ids, epoch=%lu\n"), (unsigned long)maxCycleId);
+    __ASSERT_SET_DATA_TYPE(WEAR_LEVEL_DATA);
+    _eraseAndInitialize(wearLevelDataOffset, wearLevelPayloadSize, wearLevelNumBlocks);
+    __ASSERT_SET_DATA_TYPE(EPOCH);
+    for (uint8_t i = 0; i < epochSlots; i++) {
+        _eepromClear(_getEpochOffset(i), sizeof(Epoch_t));
+    }
+    _epochCycleId = 0;
+}
+
+uint8_t ArduinoEEPROMBase::_readEpoch()
+{
+    uint8_t result = INVALID_EPOCH;
+    _epochCycleId = 0;
+    for (uint8_t i = 0; i < epochSlots; i++) {
+        Epoch_t tmp;
+        _eepromRead(_getEpochOffset(i), ByteAccessArray(&tmp), sizeof(tmp));
+        if (tmp.crc != CRC::update((CRCType)~0, &tmp.cycleId, sizeof(tmp.cycleId))) {
+            continue;
+        }
+        if (result == INVALID_EPOCH || tmp.cycleId > _epochCycleId) {
+            _epochCycleId = tmp.cycleId;
+            result = i;
+        }
+    }
+    _debug_printf_P(PSTR("slot=%u, epoch=%lu\n"), result, (unsigned long)_epochCycleId);
+    return result;
+}
+
+bool ArduinoEEPROMBase::_writeEpoch(uint32_t cycleId)
+{
+    auto slot = _readEpoch();
+    if (slot != INVALID_EPOCH && _epochCycleId == cycleId) {
+        return true;
+    }
+    // the previous epoch remains valid if the write operation gets interrupted
+    slot = (slot == 0) ? 1 : 0;
+    Epoch_t epoch;
+    epoch.cycleId = cycleId;
+    epoch.crc = CRC::update((CRCType)~0, &epoch.cycleId, sizeof(epoch.cycleId));
+
+    _debug_printf_P(PSTR("slot=%u, epoch=%lu\n"), slot, (unsigned long)cycleId);
+
+    auto slotOffset = _getEpochOffset(slot);
+    _eepromWrite(slotOffset, ConstByteAccessArray(&epoch), sizeof(epoch));
+    Epoch_t tmp;
+    _eepromRead(slotOffset, ByteAccessArray(&tmp), sizeof(tmp));
+    if (memcmp(&tmp, &epoch, sizeof(tmp)) != 0) {
+        _readEpoch();
+        return false;
+    }
+    _epochCycleId = cycleId;
+    return true;
+}
+
+ArduinoEEPROMBase::EEPROMSizeType ArduinoEEPROMBase::_getEpochOffset(uint8_t slot) const
+{
+    return epochOffset + (slot * ARDUINO_EEPROM_ALIGN_LEN(sizeof(Epoch_t)));
+}
+
+#endif
+
+ArduinoEEPROMBase::EEPROMSizeType ArduinoEEPROMBase::_getWearLevelBlockOffset(EEPROMSizeType index) const
+{
+    return wearLevelDataOffset + (index * ARDUINO_EEPROM_ALIGN_LEN(wearLevelBlockSize));
+}
+
+ArduinoEEPROMBase::EEPROMSizeType ArduinoEEPROMBase::_getWearLevelBlockIndex(EEPROMSizeType offset) const
+{
+    return (offset - wearLevelDataOffset) / ARDUINO_EEPROM_ALIGN_LEN(wearLevelBlockSize);
+}
+
+bool ArduinoEEPROMBase::_isWearLevelSequence(EEPROMSizeType first, uint32_t cycleId, EEPROMSizeType &distance, EEPROMSizeType end) const
+{
+    for (; distance < end; distance++) {
+        EEPROMSizeType index = first + distance;
+        if (index >= wearLevelNumBlocks) {
+            index -= wearLevelNumBlocks;
+        }
+        if (!_isBadBlock(index)) {
+            return _readCycleId(_getWearLevelBlockOffset(index)) == _addCycleId(cycleId, distance);
+        }
+    }
+    return false;
+}
+
+#if ARDUINO_EEPROM_HAVE_BAD_BLOCKS
+
+ArduinoEEPROMBase::EEPROMSizeType ArduinoEEPROMBase::getNumBadBlocks() const
+{
+    EEPROMSizeType count = 0;
+    for (EEPROMSizeType i = 0; i < wearLevelNumBlocks; i++) {
+        if (_isBadBlock(i)) {
+            count++;
+        }
+    }
+    return count;
+}
+
+void ArduinoEEPROMBase::_markBadBlock(EEPROMSizeType offset)
+{
+    auto index = _getWearLevelBlockIndex(offset);
+    _debug_printf_P(PSTR("%04lx: bad block index=%lu\n"), (unsigned long)offset, (unsigned long)index);
+    _badBlocks[index / 8] |= _BV(index % 8);
+    __ASSERT_SET_DATA_TYPE(BAD_BLOCKS);
+    _writeBadBlocks();
+    __ASSERT_SET_DATA_TYPE(WEAR_LEVEL_DATA);
+}
+
+void ArduinoEEPROMBase::_readBadBlocks()
+{
+    memset(_badBlocks, 0, sizeof(_badBlocks));
+    for (uint8_t i = 0; i < badBlocksCopies; i++) {
+        auto offset = _getBadBlocksOffset(i);
+        CRCType crc;
+        offset = _eepromRead(offset, ByteAccessArray(&crc), sizeof(crc));
+        // a block stays bad if it is marked in any valid copy
+        if (crc == _readBadBlocks(offset, false)) {
+            _readBadBlocks(offset, true);
+        }
+    }
+    _debug_printf_P(PSTR("bad blocks=%lu\n"), (unsigned long)getNumBadBlocks());
+}
+
+ArduinoEEPROMBase::CRCType ArduinoEEPROMBase::_readBadBlocks(EEPROMSizeType offset, bool merge)
+{
+    CRCType crc = ~0;
+    uint8_t buffer[16];
+    for (EEPROMSizeType pos = 0; pos < badBlocksSize; pos += sizeof(buffer)) {
+        DataBlockSizeType len = min(badBlocksSize - pos, (EEPROMSizeType)sizeof(buffer));
+        _eepromRead(offset + pos, ByteAccessArray(buffer), len);
+        crc = CRC::update(crc, buffer, len);
+        if (merge) {
+            for (DataBlockSizeType i = 0; i < len; i++) {
+                _badBlocks[pos + i] |= buffer[i];
+            }
+        }
+    }
+    return crc;
+}
+
+bool ArduinoEEPROMBase::_writeBadBlocks()
+{
+    CRCType crc = CRC::update((CRCType)~0, _badBlocks, sizeof(_badBlocks));
+    bool result = true;
+    for (uint8_t i = 0; i < badBlocksCopies; i++) {
+        // bitmap first and the CRC last, the other copy remains valid if the write operation gets interrupted
+        auto offset = _getBadBlocksOffset(i);
+        for (EEPROMSizeType pos = 0; pos < badBlocksSize; pos += burstSize) {
+            DataBlockSizeType len = min(badBlocksSize - pos, (EEPROMSizeType)burstSize);
+            _eepromWrite(offset + sizeof(crc) + pos, ConstByteAccessArray(&_badBlocks[pos]), len);
+        }
+        _eepromWrite(offset, ConstByteAccessArray(&crc), sizeof(crc));
+        CRCType tmp;
+        _eepromRead(offset, ByteAccessArray(&tmp), sizeof(tmp));
+        if (tmp != crc || _readBadBlocks(offset + sizeof(crc), false) != crc) {
+            _debug_printf_P(PSTR("%04lx: error\n"), (unsigned long)offset);
+            result = false;
+        }
+    }
+    return result;
+}
+
+ArduinoEEPROMBase::EEPROMSizeType ArduinoEEPROMBase::_getBadBlocksOffset(uint8_t copy) const
+{
+    return badBlocksOffset + (copy * ARDUINO_EEPROM_ALIGN_LEN(sizeof(CRCType) + badBlocksSize));
+}
+
+#endif
+
+uint32_t ArduinoEEPROMBase::_readCycleId(EEPROMSizeType offset) const
+{
+    // the CRC is not read
+    DataBlockHeader_t header;
+    offset += sizeof(header.crc);
+    __ASSERT_DATA(offset, sizeof(header) - sizeof(header.crc));
+    _eepromRead(offset, ByteAccessArray(reinterpret_cast<uint8_t *>(&header) + sizeof(header.crc)), sizeof(header) - sizeof(header.crc));
+    uint32_t cycleId = header.cycleId;
+#if ARDUINO_EEPROM_CYCLE_ID_BITS != 32
+    if (cycleId > cycleIdMax) {
+        cycleId = ~0;
+    }
+#endif
+#if ARDUINO_EEPROM_HAVE_COMMIT_MARKER
+    if (header.commit != _getCommitMarker(header.cycleId)) {
+        cycleId = ~0;
+    }
+#endif
+#if ARDUINO_EEPROM_HAVE_EPOCH
+    if (cycleId <= _epochCycleId || cycleId == (uint32_t)~0) {
+        return 0;
+    }
+#endif
+    return cycleId;
+}
+
+bool ArduinoEEPROMBase::_isEmptyBlock(EEPROMSizeType offset, uint32_t cycleId) const
+{
+#if ARDUINO_EEPROM_HAVE_EPOCH
+    if (offset >= wearLevelDataOffset) {
+        return cycleId <= _epochCycleId || cycleId == (uint32_t)~0;
+    }
+#else
+    (void)offset;
+#endif
+    return cycleId == 0;
+}
+
+void ArduinoEEPROMBase::_setDataBlockHeaderCycleId(DataBlockHeader_t &header, uint32_t cycleId) const
+{
+    header.cycleId = cycleId;
+#if ARDUINO_EEPROM_HAVE_COMMIT_MARKER
+    header.commit = _getCommitMarker(cycleId);
+#endif
+}
+
+#if ARDUINO_EEPROM_HAVE_COMMIT_MARKER
+uint8_t ArduinoEEPROMBase::_getCommitMarker(uint32_t cycleId) const
+{
+    // all 4 bytes of the cycle id have an effect on the marker
+    uint8_t marker = 0x5a;
+    for (uint8_t i = 0; i < sizeof(cycleId); i++) {
+        marker = (marker << 1 | marker >> 7) ^ (uint8_t)cycleId;
+        cycleId >>= 8;
+    }
+    return marker;
 }
+#endif
 
-uint16_t ArduinoEEPROMBase::_dataBlockHeaderCrc(const DataBlockHeader_t &header) const
+ArduinoEEPROMBase::BlockCRCType ArduinoEEPROMBase::_dataBlockHeaderCrc(const DataBlockHeader_t &header) const
 {
-    return ::crc16_update(&header.cycleId, sizeof(header) - sizeof(header.crc));
+    return BlockCRC::update((BlockCRCType)~0, reinterpret_cast<const uint8_t *>(&header) + sizeof(header.crc), sizeof(header) - sizeof(header.crc));
 }
 
 bool ArduinoEEPROMBase::_readDataBlock(EEPROMSizeType offset, ByteAccessPointer data, DataBlockSizeType size, DataBlockHeader_t &header) const
@@ -483,41 +2321,47 @@ bool ArduinoEEPROMBase::_readDataBlock(EEPROMSizeType offset, ByteAccessPointer
 #endif
 
     __ASSERT_DATA(offset, sizeof(header));
-    offset = _eepromRead(offset, ByteAccessArray(&header), sizeof(header));
-    if (header.cycleId == 0) {
+    _eepromRead(offset, ByteAccessArray(&header), sizeof(header));
+    if (_isEmptyBlock(offset, header.cycleId)) {
         return false;
     }
+    offset += sizeof(header);
     __ASSERT_DATA(offset, size);
     offset = _eepromRead(offset, data, size);
 
-    _debug_printf_P(PSTR("_readDataBlock ofs=%u, crc=%04x, id=%u\n"), tmp, header.crc, header.cycleId);
+    _debug_printf_P(PSTR("_readDataBlock ofs=%lu, crc=%04x, id=%lu\n"), (unsigned long)tmp, header.crc, (unsigned long)header.cycleId);
 
-    return header.crc == crc16_update(_dataBlockHeaderCrc(header), data, size);
+    return header.crc == _dataBlockCrcUpdate(_dataBlockHeaderCrc(header), data, size);
 }
 
-bool ArduinoEEPROMBase::_writeDataBlock(EEPROMSizeType offset, uint32_t cycleId, ConstByteAccessPointer data, DataBlockSizeType size) const
+bool ArduinoEEPROMBase::_writeDataBlock(EEPROMSizeType offset, uint32_t cycleId, ConstByteAccessPointer data, DataBlockSizeType size, uint8_t retries) const
 {
     DataBlockHeader_t header;
 
-    header.cycleId = cycleId;
-    header.crc = crc16_update(_dataBlockHeaderCrc(header), data, size);
+    _setDataBlockHeaderCycleId(header, cycleId);
+    header.crc = _dataBlockCrcUpdate(_dataBlockHeaderCrc(header), data, size);
 
-    _debug_printf_P(PSTR("_writeDataBlock ofs=%u, crc=%04x, id=%u\n"), offset, header.crc, header.cycleId);
+    _debug_printf_P(PSTR("_writeDataBlock ofs=%lu, crc=%04x, id=%lu\n"), (unsigned long)offset, header.crc, (unsigned long)header.cycleId);
 
-#if ARDUINO_EEPROM_WRITE_ERROR_RETRIES
-    for (uint8_t i = 0; i < ARDUINO_EEPROM_WRITE_ERROR_RETRIES; i++)
-#endif
-    {
-        __ASSERT_DATA(offset, sizeof(header));
-        auto ofsTmp = _eepromWrite(offset, ByteAccessArray(&header), sizeof(header));
-        __ASSERT_DATA(ofsTmp, size);
-        _eepromWrite(ofsTmp, data, size);
+    // at least one attempt
+    uint8_t i = 0;
+    do {
+        if (BlockAccess::hasBlockWrite) {
+            _eepromWriteDataBlock(offset, header, data, size);
+        }
+        else {
+            __ASSERT_DATA(offset + sizeof(header), size);
+            _eepromWrite(offset + sizeof(header), data, size);
+            __ASSERT_DATA(offset, sizeof(header));
+            _eepromWrite(offset, ByteAccessArray(&header), sizeof(header));
+        }
 
+        // a block that cannot be written anymore might still contain an older valid block
         DataBlockHeader_t hdrTmp;
-        if (_validateEepromDataBlockCrc(offset, size, hdrTmp)) {
+        if (_validateEepromDataBlockCrc(offset, size, hdrTmp) && memcmp(&hdrTmp, &header, sizeof(header)) == 0) {
             return true;
         }
-    }
+    } while (++i < retries);
 
     return false;
 }
@@ -525,6 +2369,26 @@ bool ArduinoEEPROMBase::_writeDataBlock(EEPROMSizeType offset, uint32_t cycleId,
 ArduinoEEPROMBase::EEPROMSizeType ArduinoEEPROMBase::_eepromRead(EEPROMSizeType offset, ByteAccessPointer data, DataBlockSizeType size) const
 {
     __ASSERT_DATA(offset, size);
+    if (BlockAccess::hasBlockRead) {
+#if ARDUINO_EEPROM_HAVE_BYTEARRAY_INTERFACE
+        uint8_t buffer[burstSize];
+#endif
+        while (size) {
+            DataBlockSizeType len = min(size, (DataBlockSizeType)burstSize);
+#if ARDUINO_EEPROM_HAVE_BYTEARRAY_INTERFACE
+            BlockAccess::read(_eeprom, offset, buffer, len);
+            for (DataBlockSizeType i = 0; i < len; i++) {
+                *data++ = buffer[i];
+            }
+#else
+            BlockAccess::read(_eeprom, offset, data, len);
+            data += len;
+#endif
+            offset += len;
+            size -= len;
+        }
+        return offset;
+    }
     while (size--) {
         *data++ = _eeprom.read(offset++);
     }
@@ -534,6 +2398,16 @@ ArduinoEEPROMBase::EEPROMSizeType ArduinoEEPROMBase::_eepromRead(EEPROMSizeType
 ArduinoEEPROMBase::EEPROMSizeType ArduinoEEPROMBase::_eepromClear(EEPROMSizeType offset, DataBlockSizeType size) const
 {
     __ASSERT_DATA(offset, size);
+    if (BlockAccess::hasBlockWrite) {
+        uint8_t buffer[burstSize];
+        memset(buffer, 0, sizeof(buffer));
+        while (size) {
+            auto len = _getBurstLength(offset, size);
+            offset = _eepromUpdateBlock(offset, buffer, len);
+            size -= len;
+        }
+        return offset;
+    }
     while (size--) {
         _eeprom.update(offset++, 0);
     }
@@ -543,17 +2417,73 @@ ArduinoEEPROMBase::EEPROMSizeType ArduinoEEPROMBase::_eepromClear(EEPROMSizeType
 ArduinoEEPROMBase::EEPROMSizeType ArduinoEEPROMBase::_eepromWrite(EEPROMSizeType offset, ConstByteAccessPointer data, DataBlockSizeType size) const
 {
     __ASSERT_DATA(offset, size);
+    if (BlockAccess::hasBlockWrite) {
+        uint8_t buffer[burstSize];
+        while (size) {
+            auto len = _getBurstLength(offset, size);
+            for (DataBlockSizeType i = 0; i < len; i++) {
+                buffer[i] = *data++;
+            }
+            offset = _eepromUpdateBlock(offset, buffer, len);
+            size -= len;
+        }
+        return offset;
+    }
     while (size--) {
         _eeprom.update(offset++, *data++);
     }
     return offset;
 }
 
+void ArduinoEEPROMBase::_eepromWriteDataBlock(EEPROMSizeType offset, const DataBlockHeader_t &header, ConstByteAccessPointer data, DataBlockSizeType size) const
+{
+    uint8_t buffer[sizeof(header) + burstSize];
+    memcpy(buffer, &header, sizeof(header));
+    // number of bytes of the payload in the same burst as the end of the header
+    EEPROMSizeType payloadOffset = offset + sizeof(header);
+    DataBlockSizeType len = _getBurstLength(payloadOffset - 1, size + 1) - 1;
+    for (DataBlockSizeType i = 0; i < len; i++) {
+        buffer[sizeof(header) + i] = *data++;
+    }
+    __ASSERT_DATA(payloadOffset + len, size - len);
+    _eepromWrite(payloadOffset + len, data, size - len);
+    __ASSERT_DATA(offset, sizeof(header) + len);
+    _eepromWrite(offset, ConstByteAccessArray(buffer), sizeof(header) + len);
+}
+
+ArduinoEEPROMBase::DataBlockSizeType ArduinoEEPROMBase::_getBurstLength(EEPROMSizeType offset, DataBlockSizeType size) const
+{
+    // align to the burst size to avoid crossing the page boundary of the EEPROM
+    DataBlockSizeType len = min(size, (DataBlockSizeType)(burstSize - (offset % burstSize)));
+#if ARDUINO_EEPROM_PAGE_SIZE > 1
+    len = min(len, (DataBlockSizeType)(pageSize - (offset % pageSize)));
+#endif
+    return len;
+}
+
+ArduinoEEPROMBase::EEPROMSizeType ArduinoEEPROMBase::_eepromUpdateBlock(EEPROMSizeType offset, const uint8_t *data, DataBlockSizeType len) const
+{
+    uint8_t current[burstSize];
+    BlockAccess::read(_eeprom, offset, current, len);
+    DataBlockSizeType first = 0;
+    while (first < len && current[first] == data[first]) {
+        first++;
+    }
+    if (first < len) {
+        DataBlockSizeType last = len;
+        while (current[last - 1] == data[last - 1]) {
+            last--;
+        }
+        BlockAccess::write(_eeprom, offset + first, data + first, last - first);
+    }
+    return offset + len;
+}
+
 #if ARDUINO_EEPROM_HAVE_BYTEARRAY_INTERFACE
-uint16_t ArduinoEEPROMBase::crc16_update(uint16_t crc, ConstByteAccessPointer data, size_t len) const
+ArduinoEEPROMBase::BlockCRCType ArduinoEEPROMBase::_dataBlockCrcUpdate(BlockCRCType crc, ConstByteAccessPointer data, size_t len) const
 {
     while (len--) {
-        crc = ::crc16_update(crc, *data++);
+        crc = BlockCRC::update(crc, (uint8_t)*data++);
     }
     return crc;
 }
@@ -566,11 +2496,23 @@ bool ArduinoEEPROMBase::_validateEepromDataBlockCrc(EEPROMSizeType offset, DataB
 #endif
     __ASSERT_DATA(offset, sizeof(header));
     offset = _eepromRead(offset, ByteAccessArray(&header), sizeof(header));
-    CRCType crc = _dataBlockHeaderCrc(header);
+    BlockCRCType crc = _dataBlockHeaderCrc(header);
     __ASSERT_DATA(offset, size);
-    while (size--) {
-        crc = ::crc16_update(crc, _eeprom.read(offset++));
+    if (BlockAccess::hasBlockRead || ARDUINO_EEPROM_CRC_ENGINE == ARDUINO_EEPROM_CRC_SLICE_BY_8) {
+        // read the payload in bursts. slicing-by-8 processes 8 byte per iteration
+        uint8_t buffer[burstSize];
+        while (size) {
+            DataBlockSizeType len = min(size, (DataBlockSizeType)burstSize);
+            offset = _eepromRead(offset, ByteAccessArray(buffer), len);
+            crc = BlockCRC::update(crc, buffer, len);
+            size -= len;
+        }
+    }
+    else {
+        while (size--) {
+            crc = BlockCRC::update(crc, _eeprom.read(offset++));
+        }
     }
-    _debug_printf_P(PSTR("_validateEepromDataBlockCrc ofs=%u, crc=%04x, eeprom.crc=%04x, id=%u\n"), tmp, header.crc, crc, header.cycleId);
+    _debug_printf_P(PSTR("_validateEepromDataBlockCrc ofs=%lu, crc=%04x, eeprom.crc=%04x, id=%lu\n"), (unsigned long)tmp, header.crc, crc, (unsigned long)header.cycleId);
     return crc == header.crc;
 }